@@ -0,0 +1,153 @@
+// arena.c
+//
+// 6502 emulator program
+// 	Arena allocator for fleets of buses and CPUs
+//
+// Brian K. Niece
+//
+// Tens of thousands of buses each allocating 64K of RAM, plus their
+// 	blocks and CPUs, spread over the heap and the TLB.  An arena packs
+// 	them into a few big aligned regions, huge pages where the host gives
+// 	them out, and frees them all together.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "arena.h"
+
+#if !defined(_WIN32)
+#define ARENA_MMAP
+#include <sys/mman.h>
+#endif
+
+static arena_region *new_region(size_t size, int huge)
+// A cleared region of at least size bytes
+{
+	arena_region *region = malloc(sizeof(arena_region));
+	if (region == NULL)
+	{
+		return NULL;
+	}
+
+	region->base = NULL;
+	region->used = 0;
+	region->mapped = 0;
+
+#ifdef ARENA_MMAP
+	// Huge pages need the size in whole huge pages
+	if (huge)
+	{
+		size = (size + HUGE_PAGE - 1) & ~((size_t)HUGE_PAGE - 1);
+	}
+
+#ifdef MAP_HUGETLB
+	// Reserved huge pages first, often there are none
+	if (huge)
+	{
+		region->base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	}
+#endif
+	if ((region->base == NULL) || (region->base == MAP_FAILED))
+	{
+		region->base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+#ifdef MADV_HUGEPAGE
+		// Then ask for transparent huge pages
+		if (huge && (region->base != MAP_FAILED))
+		{
+			madvise(region->base, size, MADV_HUGEPAGE);
+		}
+#endif
+	}
+	if (region->base != MAP_FAILED)
+	{
+		region->mapped = 1;
+	}
+	else
+	{
+		region->base = NULL;
+	}
+#endif
+
+	if (region->base == NULL)
+	{
+		region->base = calloc(size, 1);
+	}
+	if (region->base == NULL)
+	{
+		free(region);
+		return NULL;
+	}
+
+	region->size = size;
+	return region;
+}
+
+void init_arena(arena *a, size_t region_size, int huge)
+{
+	a->regions = NULL;
+	a->region_size = (region_size == 0) ? ARENA_REGION : region_size;
+	a->huge = huge;
+}
+
+static size_t align_offset(arena_region *region, size_t align)
+// First offset past what's used that is aligned in host memory
+{
+	uintptr_t addr = (uintptr_t)(region->base + region->used);
+
+	return ((addr + align - 1) & ~(uintptr_t)(align - 1)) -
+		(uintptr_t)region->base;
+}
+
+void *arena_alloc(arena *a, size_t size, size_t align)
+{
+	arena_region *region = a->regions;
+	size_t offset = 0;
+
+	if (region != NULL)
+	{
+		offset = align_offset(region, align);
+	}
+
+	// Start a new region when this one is full, big enough for size
+	if ((region == NULL) || (offset + size > region->size))
+	{
+		region = new_region((size + align > a->region_size) ?
+			size + align : a->region_size, a->huge);
+		if (region == NULL)
+		{
+			return NULL;
+		}
+		region->next = a->regions;
+		a->regions = region;
+		offset = align_offset(region, align);
+	}
+
+	region->used = offset + size;
+	return region->base + offset;
+}
+
+void free_arena(arena *a)
+{
+	while (a->regions != NULL)
+	{
+		arena_region *region = a->regions;
+		a->regions = region->next;
+
+#ifdef ARENA_MMAP
+		if (region->mapped)
+		{
+			munmap(region->base, region->size);
+		}
+		else
+		{
+			free(region->base);
+		}
+#else
+		free(region->base);
+#endif
+		free(region);
+	}
+}
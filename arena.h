@@ -0,0 +1,48 @@
+// arena.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Arena allocator for fleets of buses and CPUs
+//
+// Brian K. Niece
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Default region size, and the huge page size regions are rounded up to
+#define ARENA_REGION (32 * 1024 * 1024)
+#define HUGE_PAGE (2 * 1024 * 1024)
+
+// One big block the arena hands out pieces of
+typedef struct arena_region
+{
+	unsigned char *base;
+	size_t size;
+	size_t used;
+	int mapped;					// 1 if from mmap, 0 if from malloc
+	struct arena_region *next;
+} arena_region;
+
+// Allocations come from the newest region, a new one is added when it
+// 	fills.  Nothing is freed on its own, only the whole arena at once.
+typedef struct arena
+{
+	arena_region *regions;	// newest first
+	size_t region_size;
+	int huge;
+} arena;
+
+void init_arena(arena *a, size_t region_size, int huge);
+	// region_size 0 for ARENA_REGION
+	// huge asks for huge pages, normal pages are used where there are none
+	// 	Huge pages back a whole 2M at a time, so they pay off when the
+	// 	programs use most of their RAM, and cost memory when they don't
+void *arena_alloc(arena *a, size_t size, size_t align);
+	// align is a power of 2
+	// returns cleared memory
+	// 		NULL if the host is out of memory
+void free_arena(arena *a);
+	// Frees everything allocated from the arena
+
+#endif
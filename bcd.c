@@ -0,0 +1,140 @@
+// bcd.c
+//
+// 6502 emulator program
+// 	Lookup tables for decimal mode arithmetic
+//
+// Brian K. Niece
+//
+// Every engine used to redo the nibble corrections for each decimal ADC
+// 	and SBC.  The result only depends on A, the operand and the carry,
+// 	so it's worked out once here for all 128k combinations and looked
+// 	up after that.  The algorithms are the ones the BCD handlers in
+// 	instructions.c used, including their N, V and Z results.
+//
+// Every CPU asks for the tables, and a fleet sets up its CPUs on several
+// 	threads, so the tables are filled in under a once guard.
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "bcd.h"
+
+word bcd_adc_table[2][256][256];
+word bcd_sbc_table[2][256][256];
+
+static word add_decimal(byte old_A, byte M, byte old_C)
+// Add with Carry in BCD mode
+// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+{
+	byte sr = 0;
+
+	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
+	if (AL >= 0x0A)
+	{
+		AL = ((AL + 0x06) & 0x0F) + 0x10;
+	}
+	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
+
+	// N and V come from the uncorrected sum
+	sr |= new_A & N;
+	if (new_A > 127)
+	{
+		sr |= V;
+	}
+
+	if (new_A >= 0xA0)
+	{
+		new_A = new_A + 0x60;
+	}
+
+	if (new_A >= 0x100)
+	{
+		sr |= C;
+	}
+
+	// Z comes from the binary sum
+	if (((old_A + M + old_C) & 0xFF) == 0)
+	{
+		sr |= Z;
+	}
+
+	return (sr << 8) | (new_A & 0xFF);
+}
+
+static word subtract_decimal(byte old_A, byte M, byte old_C)
+// Subtract with Carry in BCD mode
+// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+{
+	byte sr = 0;
+
+	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
+	if (AL < 0)
+	{
+		AL = ((AL - 0x06) & 0x0F) - 0x10;
+	}
+	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
+	if (new_A < 0)
+	{
+		new_A = new_A - 0x60;
+	}
+
+	// C,N,V,Z come from the binary subtraction
+	int result = old_A + (~M & 0xFF) + old_C;
+	sr |= (result >> 8) & C;
+	sr |= result & N;
+	if (((old_A ^ result) & (~M ^ result) & 0x80) != 0)
+	{
+		sr |= V;
+	}
+	if ((result & 0xFF) == 0)
+	{
+		sr |= Z;
+	}
+
+	return (sr << 8) | (new_A & 0xFF);
+}
+
+static void fill_tables(void)
+{
+	for (int carry = 0; carry < 2; carry++)
+	{
+		for (int A = 0; A < 256; A++)
+		{
+			for (int M = 0; M < 256; M++)
+			{
+				bcd_adc_table[carry][A][M] = add_decimal(A, M, carry);
+				bcd_sbc_table[carry][A][M] = subtract_decimal(A, M, carry);
+			}
+		}
+	}
+}
+
+#if defined(_WIN32)
+static BOOL CALLBACK fill_tables_once(PINIT_ONCE once, PVOID param,
+		PVOID *context)
+{
+	UNREFERENCED_PARAMETER(once);
+	UNREFERENCED_PARAMETER(param);
+	UNREFERENCED_PARAMETER(context);
+	fill_tables();
+	return TRUE;
+}
+
+void init_bcd_tables(void)
+{
+	static INIT_ONCE once = INIT_ONCE_STATIC_INIT;
+
+	InitOnceExecuteOnce(&once, fill_tables_once, NULL, NULL);
+}
+#else
+void init_bcd_tables(void)
+{
+	static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+	pthread_once(&once, fill_tables);
+}
+#endif
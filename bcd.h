@@ -0,0 +1,22 @@
+// bcd.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Lookup tables for decimal mode arithmetic
+//
+// Brian K. Niece
+
+#ifndef BCD_H
+#define BCD_H
+
+#include "cpu.h"
+
+// Results of ADC and SBC in decimal mode, indexed by carry, A and M
+// 	The low byte is the new A, the high byte holds N, V, Z and C as
+// 	they are in the status register.
+extern word bcd_adc_table[2][256][256];
+extern word bcd_sbc_table[2][256][256];
+
+// Fill in the tables, safe to call more than once and from any thread
+void init_bcd_tables(void);
+
+#endif
@@ -0,0 +1,386 @@
+// blockcache.c
+//
+// 6502 emulator program
+// 	Decoded basic block cache engine
+//
+// Brian K. Niece
+//
+// A third execution engine built from the same instruction bodies as the
+// 	threaded engine (opbodies.h).  Instead of fetching each opcode and
+// 	its operand bytes from the bus every time, a straight run of
+// 	instructions is decoded once into an array of micro-ops with the
+// 	operand already fetched.  The run ends at the first branch, jump,
+// 	return or BRK, or after BLOCK_MAX_OPS instructions.  Blocks are kept
+// 	by starting address, so a loop body is decoded the first time
+// 	through and then run from the cache.
+//
+// Code isn't write protected, so a program can change itself.  Each page
+// 	holding a decoded block is marked, and a store into a marked page
+// 	throws out every block that touches the page.  The current block is
+// 	abandoned after the store, so the next instruction is decoded again
+// 	from memory.
+//
+// Banking a window over cached code (map_bank) calls the bus code_write
+// 	hook.  The pages are only marked stale there, since the block that
+// 	did the store may be one of them.  The store then ends the block the
+// 	same way as a store into cached code, and the stale blocks go.
+//
+// Common pairs of instructions (fusedpairs.h) are fused when a block is
+// 	decoded.  The first micro-op of the pair gets a code that runs both
+// 	bodies in one step, and the second stays in the block to hold its
+// 	operand.
+//
+// The cache only lives for one call of run_blocks().
+
+#include <stdlib.h>
+
+#include "blockcache.h"
+#include "instructions.h"
+#include "membus.h"
+#include "opcore.h"
+
+// Longest run of instructions decoded into one block
+#define BLOCK_MAX_OPS 32
+
+// Pseudo opcodes that end a micro-op array
+#define UOP_END 0x100	// ran off the end of the block
+#define UOP_SMC 0x101	// a store changed cached code, look up PC again
+
+// Fused pair codes follow the pseudo opcodes, UOP_0868 and so on
+enum
+{
+	UOP_FUSED = UOP_SMC,
+#define FUSE(a, b)	UOP_##a##b,
+#include "fusedpairs.h"
+#undef FUSE
+	UOP_LAST
+};
+
+typedef struct uop
+{
+	word op;			// opcode or UOP_ value
+	word operand;		// operand byte or address, already fetched
+} uop;
+
+typedef struct block
+{
+	word begin;			// address of the first instruction
+	word end;			// address of the last byte of the last instruction
+	uop ops[BLOCK_MAX_OPS + 1];
+} block;
+
+typedef struct block_cache
+{
+	block *entry[MAX_MEM];		// block starting at each address
+	byte code_page[NUM_PAGES];	// 1 if a block touches the page
+	byte stale[NUM_PAGES];		// 1 if the page was banked since decoding
+	byte remapped;					// 1 if any page is stale
+} block_cache;
+
+static int ends_block(byte op)
+// Check for instructions that may not fall through to the next one
+{
+	switch (op)
+	{
+		case 0x00:	// BRK
+		case 0x10: case 0x30: case 0x50: case 0x70:	// branches
+		case 0x90: case 0xB0: case 0xD0: case 0xF0:
+		case 0x20:	// JSR
+		case 0x40:	// RTI
+		case 0x4C:	// JMP abs
+		case 0x60:	// RTS
+		case 0x6C:	// JMP ind
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+static word fuse_pair(byte first, byte second)
+// Fused micro-op for an instruction pair, 0 if the pair isn't fused
+{
+	switch ((first << 8) | second)
+	{
+#define FUSE(a, b)	case 0x##a##b: return UOP_##a##b;
+#include "fusedpairs.h"
+#undef FUSE
+		default:
+			return 0;
+	}
+}
+
+static block *decode_block(block_cache *cache, membus *bus, word pc)
+// Decode instructions starting at pc into a new block and cache it
+{
+	block *blk = malloc(sizeof(block));
+	int n = 0;
+	int fused = 0;
+	byte op;
+
+	blk->begin = pc;
+	do
+	{
+		op = read(bus, pc);
+		blk->ops[n].op = op;
+		switch (op_length[op])
+		{
+			case 2:
+				blk->ops[n].operand = read(bus, pc + 1);
+				break;
+			case 3:
+				blk->ops[n].operand = read(bus, pc + 1) +
+					(read(bus, pc + 2) << 8);
+				break;
+			default:
+				blk->ops[n].operand = 0;
+				break;
+		}
+		blk->end = pc + op_length[op] - 1;
+		pc += op_length[op];
+
+		// Fuse with the instruction before, unless that one is already
+		// 	the second half of a pair
+		if ((n > 0) && (fused == 0))
+		{
+			word f = fuse_pair(blk->ops[n - 1].op, op);
+			if (f != 0)
+			{
+				blk->ops[n - 1].op = f;
+				fused = 1;
+			}
+		}
+		else
+		{
+			fused = 0;
+		}
+		n++;
+	} while ((ends_block(op) == 0) && (n < BLOCK_MAX_OPS));
+	blk->ops[n].op = UOP_END;
+	blk->ops[n].operand = 0;
+
+	// Mark the pages the block was decoded from
+	// 	(byte so a block at the top of memory wraps to page 0)
+	for (byte pg = blk->begin >> 8; ; pg++)
+	{
+		cache->code_page[pg] = 1;
+		if (pg == (blk->end >> 8))
+		{
+			break;
+		}
+	}
+
+	cache->entry[blk->begin] = blk;
+	return blk;
+}
+
+static void invalidate_page(block_cache *cache, byte pg)
+// Throw out every block that touches page pg
+// 	A block is shorter than a page, so it can only start in pg or the
+// 	page before it.
+{
+	word addr = (byte)(pg - 1) << 8;
+
+	for (int i = 0; i < 2 * PAGE_SIZE; i++, addr++)
+	{
+		block *blk = cache->entry[addr];
+		if ((blk != NULL) &&
+				(((blk->begin >> 8) == pg) || ((blk->end >> 8) == pg)))
+		{
+			free(blk);
+			cache->entry[addr] = NULL;
+		}
+	}
+
+	cache->code_page[pg] = 0;
+}
+
+static void drop_blocks(block_cache *cache, byte pg)
+// Throw out the blocks a store just made stale, in page pg and any
+// 	banked pages
+{
+	if (cache->code_page[pg] != 0)
+	{
+		invalidate_page(cache, pg);
+	}
+
+	if (cache->remapped != 0)
+	{
+		for (int i = 0; i < NUM_PAGES; i++)
+		{
+			if (cache->stale[i] != 0)
+			{
+				invalidate_page(cache, i);
+				cache->stale[i] = 0;
+			}
+		}
+		cache->remapped = 0;
+	}
+}
+
+static void block_remap(void *p, word addr, int len)
+// Bus hook, a bank was mapped over the page at addr
+{
+	block_cache *cache = p;
+	byte pg = addr >> 8;
+
+	if (cache->code_page[pg] != 0)
+	{
+		cache->stale[pg] = 1;
+		cache->remapped = 1;
+	}
+}
+
+// Operands were fetched when the block was decoded
+#define OPR8		((byte)u->operand)
+#define OPR16		(u->operand)
+
+// Stores into a page with cached code, or that banked one, end the block
+// 	after this instruction.  The current micro-op is copied first since
+// 	the rest of the body (JSR) may still need its operand.
+#define WR(a, v) \
+	waddr = (a); \
+	write(bus, waddr, (v)); \
+	if ((cache->code_page[waddr >> 8] | cache->remapped) != 0) \
+	{ \
+		if (u != exit_block) \
+		{ \
+			count += u - blk->ops + 1; \
+			exit_block[0] = *u; \
+			u = exit_block; \
+		} \
+		drop_blocks(cache, waddr >> 8); \
+	}
+
+// Move on to the next instruction
+#define NEXT(bytes, cyc)	PC += (bytes); cycles += (cyc); DISPATCH()
+
+// Finish the first instruction of a fused pair and start the second
+// 	If the first one's store threw out the block, the second is decoded
+// 	again from memory.
+#define THEN(bytes, cyc) \
+	PC += (bytes); \
+	cycles += (cyc); \
+	if (u == exit_block) \
+	{ \
+		goto lookup; \
+	} \
+	u++
+
+#ifdef THREADED_GOTO
+#define OPCODE(op)	op_##op:
+#define FUSED(a, b)	op_##a##b:
+#define UNDEFINED
+#define DISPATCH()	u++; goto *dispatch[u->op]
+#else
+#define OPCODE(op)	case 0x##op:
+#define FUSED(a, b)	case UOP_##a##b:
+#define UNDEFINED	default:
+#define DISPATCH()	u++; continue
+#endif
+
+void run_blocks(CPU *cpu, unsigned long long *cycles_out,
+		unsigned long long *count_out)
+{
+	membus *bus = cpu->bus;
+	block_cache *cache = calloc(1, sizeof(block_cache));
+	void (*old_code_write)(void *, word, int) = bus->code_write;
+	void *old_code_ctx = bus->code_ctx;
+
+	// Working copies of the registers
+	word PC = cpu->PC;
+	byte SP = cpu->SP;
+	byte A = cpu->A;
+	byte X = cpu->X;
+	byte Y = cpu->Y;
+	byte SR = get_SR(cpu);
+
+	// Scratch used by the handler bodies
+	byte M, zad;
+	word addr, base, waddr;
+	int r;
+
+	unsigned long long cycles = 0;
+	unsigned long long count = 0;
+
+	// Current block and micro-op
+	// 	exit_block stands in for the rest of a block that was thrown out
+	uop exit_block[2] = { { 0, 0 }, { UOP_SMC, 0 } };
+	block *blk;
+	const uop *u;
+
+	// Hear about banking, writes are checked in WR
+	bus->code_write = block_remap;
+	bus->code_ctx = cache;
+
+#ifdef THREADED_GOTO
+	static const void *dispatch[UOP_LAST] =
+	{
+		OPCODE_LABELS,
+		&&op_100, &&op_101,		// UOP_END, UOP_SMC
+#define FUSE(a, b)	&&op_##a##b,
+#include "fusedpairs.h"
+#undef FUSE
+	};
+#endif
+
+lookup:
+	blk = cache->entry[PC];
+	if (blk == NULL)
+	{
+		blk = decode_block(cache, bus, PC);
+	}
+	u = blk->ops;
+
+#ifdef THREADED_GOTO
+	goto *dispatch[u->op];
+#else
+	for (;;)
+	{
+		switch (u->op)
+		{
+#endif
+
+#include "opbodies.h"
+#include "fusedbodies.h"
+
+	OPCODE(00)
+		// BRK ends the program, as in do_BRK_impl
+		count += u - blk->ops + 1;
+		PC++;
+		cycles += 7;
+		goto done;
+
+	OPCODE(100)
+		// End of the block, PC is the next instruction
+		count += u - blk->ops;
+		goto lookup;
+
+	OPCODE(101)
+		// Cached code changed, instructions were already counted
+		goto lookup;
+
+#ifndef THREADED_GOTO
+		}
+	}
+#endif
+
+done:
+	cpu->PC = PC;
+	cpu->SP = SP;
+	cpu->A = A;
+	cpu->X = X;
+	cpu->Y = Y;
+	cpu->SR = SR;
+	cpu->IR = 0x00;
+
+	*cycles_out += cycles;
+	*count_out += count;
+
+	bus->code_write = old_code_write;
+	bus->code_ctx = old_code_ctx;
+	for (int i = 0; i < MAX_MEM; i++)
+	{
+		free(cache->entry[i]);
+	}
+	free(cache);
+}
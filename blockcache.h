@@ -0,0 +1,18 @@
+// blockcache.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Decoded basic block cache engine
+//
+// Brian K. Niece
+
+#ifndef BLOCKCACHE_H
+#define BLOCKCACHE_H
+
+#include "cpu.h"
+
+// Run from cpu->PC until a BRK is executed
+// 	Cycles used and instructions executed are added to *cycles and *count
+void run_blocks(CPU *cpu, unsigned long long *cycles,
+		unsigned long long *count);
+
+#endif
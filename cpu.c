@@ -6,6 +6,9 @@
 // Brian K. Niece
 
 #include "cpu.h"
+#include "arena.h"
+#include "bcd.h"
+#include "instructions.h"
 #include "membus.h"
 
 void initialize_cpu(CPU *cpu, membus *bus)
@@ -14,10 +17,47 @@ void initialize_cpu(CPU *cpu, membus *bus)
 	// 	and peripherals
 	cpu->bus = bus;
 
+	// Point to the shared instruction tables.  The one used for each
+	// 	instruction is picked by the D flag, so SED, CLD, PLP, and RTI
+	// 	all switch between binary and BCD arithmetic.
+	cpu->optable[0] = execute_binary;
+	cpu->optable[1] = execute_decimal;
+
+	// Decimal ADC and SBC look their results up
+	init_bcd_tables();
+
+	// Start with cleared registers so a run doesn't depend on whatever
+	// 	was in memory.  In particular D must be clear, since the engines
+	// 	choose binary or BCD arithmetic from it.
+	cpu->TC = 0;
+	cpu->PC = 0;
+	cpu->IR = 0;
+	cpu->SP = 0;
+	cpu->A = 0;
+	cpu->X = 0;
+	cpu->Y = 0;
+	cpu->SR = 0;
+	cpu->lazy = 0;
+	cpu->n_src = 0;
+	cpu->z_src = 0;
+	cpu->v_op1 = 0;
+	cpu->v_op2 = 0;
+	cpu->v_result = 0;
+
 	// Set bit 5 of the status register because it is always 1
 	cpu->SR = cpu->SR | 32;
 }
 
+CPU *new_cpu(struct arena *a, membus *bus)
+{
+	CPU *cpu = arena_alloc(a, sizeof(CPU), 64);
+	if (cpu != NULL)
+	{
+		initialize_cpu(cpu, bus);
+	}
+	return cpu;
+}
+
 void reset(CPU *cpu)
 // Performs hardware reset as described in the Synertek 
 // 	SY6500 data sheet
@@ -34,71 +74,17 @@ void reset(CPU *cpu)
 	// 	you should set it yourself, i.e., start your code 
 	// 	with LDX #$FF, TXS
 	// 	and possibly also CLD
-	cpu->PC = read(*cpu->bus, 0xFFFC) + (read(*cpu->bus, 0xFFFD) << 8);
+	cpu->PC = read(cpu->bus, 0xFFFC) + (read(cpu->bus, 0xFFFD) << 8);
 }
 
-void set_N(CPU *cpu, byte reg)
-// Check bit 7 of reg and set or clear negative flag
+void save_snapshot(CPU *cpu, snapshot *snap)
 {
-	// N is bit 7 of the status register.  
-	// That can't be an accident, so let's use it.
-	if((reg & N) == 0)
-	{
-		cpu->SR &= ~N;
-	}
-	else
-	{
-		cpu->SR |= N;
-	}
+	snap->cpu = *cpu;
+	save_mem(cpu->bus, &snap->mem);
 }
 
-void set_V(CPU *cpu, byte op1, byte op2, byte result)
-// Set or clear the overflow flag baed on any change in bit 7
-// 	This is the hardware logic invoked after arithmetic, not to be
-// 	confused with the opcode CLV
+void restore_snapshot(CPU *cpu, snapshot *snap)
 {
-	//	Set overflow if both operands have the same sign
-	//		and the result has the opposite
-	//	Works for subtraction also, as long as the operand is passed in
-	//		as the negated value that was added.
-	//	This is not the method used by the hardware, which would require 
-	//		access to the carry from bit 6 to 7, which we don't have.
-	if (((op1^result) & (op2^result) & 0x80) == 0)
-			{
-				cpu->SR &= ~V;
-			} 
-			else
-			{
-				cpu->SR |= V;
-			}
+	*cpu = snap->cpu;
+	restore_mem(cpu->bus, &snap->mem);
 }
-
-void set_Z(CPU *cpu, byte reg)
-// Set or clear zero flag
-{
-	if(reg == 0)
-	{
-		cpu->SR |= Z;
-	}
-	else
-	{
-		cpu->SR &= ~Z;
-	}
-}
-
-void set_C(CPU *cpu, int result)
-// Set or clear carry flag 
-// 	This is the hardware logic invoked after arithmetic, not to be
-// 	confused with the opcodes SEC and CLC
-{
-	// The C int has the extra bit to make this check easy
-	if ((result & bit8) == 0)
-	{
-		cpu->SR &= ~C;
-	}
-	else
-	{
-		cpu->SR |= C;
-	}
-}
-
@@ -24,6 +24,11 @@
 typedef unsigned char byte;
 typedef unsigned short word;
 
+// Instruction handler, struct opreturn is defined in instructions.h
+struct opreturn;
+struct CPU;
+typedef struct opreturn (*ophandler)(struct CPU *cpu);
+
 typedef struct CPU
 {
 	byte TC;			// Timing control
@@ -36,16 +41,119 @@ typedef struct CPU
 	byte Y;			// Index register Y
 	
 	byte SR;			// Processor status register
+							// 	N, V and Z may be out of date, see update_SR
+
+	// Lazy flags
+	// 	The handlers record what N, Z and V depend on rather than working
+	// 	them out, since most are replaced before anything reads them.
+	// 	Bits set in lazy mark the flags in SR that are out of date.
+	byte lazy;
+	byte n_src;		// N is bit 7 of this
+	byte z_src;		// Z is set if this is 0
+	byte v_op1;		// V comes from the last set_V
+	byte v_op2;
+	byte v_result;
+	
+	const ophandler *optable[2];	// Instruction tables, binary & decimal
 	
 	membus *bus;	// Pointer to the memory "bus"
 } CPU;
 
+// Registers and memory, to go back to instead of reloading and resetting
+typedef struct snapshot
+{
+	CPU cpu;
+	mem_snapshot mem;
+} snapshot;
+
 // CPU control functions
 void initialize_cpu(CPU *cpu, membus *bus);
+CPU *new_cpu(struct arena *a, membus *bus);
+	// An initialized CPU from the arena
+	// returns NULL if the host is out of memory
 void reset(CPU *cpu);
-void set_N(CPU *cpu, byte reg);
-void set_V(CPU *cpu, byte op1, byte op2, byte result);
-void set_Z(CPU *cpu, byte reg);
-void set_C(CPU *cpu, int result);
+void save_snapshot(CPU *cpu, snapshot *snap);
+void restore_snapshot(CPU *cpu, snapshot *snap);
+	// Only the pages written since the snapshot are copied back
+
+// Flag updates
+// 	These are inline since nearly every handler calls them
+
+static inline void set_N(CPU *cpu, byte reg)
+// Negative flag from bit 7 of reg
+{
+	cpu->n_src = reg;
+	cpu->lazy |= N;
+}
+
+static inline void set_V(CPU *cpu, byte op1, byte op2, byte result)
+// Overflow flag from an addition
+// 	This is the hardware logic invoked after arithmetic, not to be
+// 	confused with the opcode CLV
+{
+	cpu->v_op1 = op1;
+	cpu->v_op2 = op2;
+	cpu->v_result = result;
+	cpu->lazy |= V;
+}
+
+static inline void set_Z(CPU *cpu, byte reg)
+// Zero flag from reg
+{
+	cpu->z_src = reg;
+	cpu->lazy |= Z;
+}
+
+static inline void set_C(CPU *cpu, int result)
+// Set or clear carry flag 
+// 	This is the hardware logic invoked after arithmetic, not to be
+// 	confused with the opcodes SEC and CLC
+// 	Carry is read by too many instructions to be worth putting off.
+{
+	// The C int has the extra bit to make this check easy
+	cpu->SR = (cpu->SR & ~C) | ((result & bit8) ? C : 0);
+}
+
+static inline void update_SR(CPU *cpu)
+// Bring N, V and Z in SR up to date
+// 	Needed before anything reads those flags or changes SR directly
+{
+	if (cpu->lazy != 0)
+	{
+		byte sr = cpu->SR & ~cpu->lazy;
+
+		// N is bit 7 of the status register.  
+		// That can't be an accident, so let's use it.
+		if ((cpu->lazy & N) != 0)
+		{
+			sr |= cpu->n_src & N;
+		}
+		if (((cpu->lazy & Z) != 0) && (cpu->z_src == 0))
+		{
+			sr |= Z;
+		}
+
+		//	Set overflow if both operands have the same sign
+		//		and the result has the opposite
+		//	Works for subtraction also, as long as the operand is passed in
+		//		as the negated value that was added.
+		if (((cpu->lazy & V) != 0) &&
+				(((cpu->v_op1 ^ cpu->v_result) & (cpu->v_op2 ^ cpu->v_result) &
+				0x80) != 0))
+		{
+			sr |= V;
+		}
+
+		cpu->SR = sr;
+		cpu->lazy = 0;
+	}
+}
+
+static inline byte get_SR(CPU *cpu)
+// Status register with every flag up to date
+{
+	update_SR(cpu);
+	return cpu->SR;
+}
 
 #endif
@@ -7,10 +7,20 @@
 #include <getopt.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "em6502.h"
 #include "cpu.h"
 #include "instructions.h"
+#include "threaded.h"
+#include "blockcache.h"
+#include "jit.h"
+#include "run.h"
+#include "loader.h"
+#ifdef RECOMPILED
+#include "recomp.h"
+#endif
 #include "version.h"
 
 int main(int argc, char *argv[])
@@ -18,10 +28,14 @@ int main(int argc, char *argv[])
    int c, opt_idx = 0;	// getopt variables
 	int r;					// memory operation result
 	int print_log = 1;	// enable/disable code log
-	struct opreturn opr; // operation result
+	int engine = ENGINE_TABLE;	// execution engine
+	run_limits limits;	// limits on a table engine run
+	trace_state trace;	// code log, pair profile and guest profile
 
 	// Track performance
-	int cycle_count = 0;
+	unsigned long long cycle_count = 0;
+	unsigned long long instruction_count = 0;
+	clock_t start_time, end_time;
 
 	// Addresses of memory segments for quick reference
 	word zero_page = 0x00;
@@ -33,12 +47,40 @@ int main(int argc, char *argv[])
 	char *code_file = "code.bin";
 	char *data_file = "data.bin";
 	char *out_file = "out.bin";
+	char *image_file = NULL;
+	char *trace_name = NULL;
+	trace_file bin_trace;
+	int trace_mode = TRACE_BLOCK;
+	int trace_delta = 0;
+	trace_filter filter;
+	int use_filter = 0;
+	unsigned long long cycle_begin, cycle_end;
+	char *group;
+	load_info image;
+	char *profile_file = "profile.folded";
+	profile prof;
 
 	// Output parameters
 	int code_pages = 1;
 	int data_pages = 1;
 	int print_stack = 1;
 	int print_zpg = 1;
+	int print_speed = 0;
+	int jit_check = 0;
+	int print_pairs = 0;
+	int print_profile = 0;
+	unsigned long long profile_every = 0;
+	int map_files = 0;
+	int out_mapped = 0;
+	int repeat = 1;
+	int save_written = 0;
+	int watch_log = 0;
+	unsigned int watch_begin, watch_end;
+	snapshot *snap = NULL;
+
+	// No limits unless asked for
+	no_limits(&limits);
+	init_filter(&filter);
 
    // Parse and handle any options
    opterr = 0;
@@ -56,10 +98,34 @@ int main(int argc, char *argv[])
 		{"print-stack", required_argument, 0, 'S'},
 		{"print-zero-page", required_argument, 0, 'Z'},
 		{"print-code-log", required_argument, 0, 'L'},
+		{"engine", required_argument, 0, 'E'},
+		{"print-speed", required_argument, 0, 'M'},
+		{"jit-check", required_argument, 0, 'J'},
+		{"print-pairs", required_argument, 0, 'P'},
+		{"cycle-budget", required_argument, 0, 'B'},
+		{"instruction-budget", required_argument, 0, 'N'},
+		{"target", required_argument, 0, 'T'},
+		{"map-files", required_argument, 0, 'm'},
+		{"repeat", required_argument, 0, 'R'},
+		{"save-written", required_argument, 0, 'W'},
+		{"watch-read", required_argument, 0, 'r'},
+		{"watch-write", required_argument, 0, 'w'},
+		{"watch-exec", required_argument, 0, 'x'},
+		{"watch-log", required_argument, 0, 'K'},
+		{"load", required_argument, 0, 'l'},
+		{"trace-file", required_argument, 0, 't'},
+		{"trace-full", required_argument, 0, 'F'},
+		{"trace-delta", required_argument, 0, 'z'},
+		{"trace-pc", required_argument, 0, 'A'},
+		{"trace-ops", required_argument, 0, 'O'},
+		{"trace-cycles", required_argument, 0, 'Y'},
+		{"profile", required_argument, 0, 'H'},
+		{"profile-sample", required_argument, 0, 'I'},
+		{"profile-file", required_argument, 0, 'U'},
       {0, 0, 0, 0}
    };
 
-   while ((c = getopt_long(argc, argv, "vc:d:p:i:o:C:D:S:Z:L:", long_opts, &opt_idx)) != -1)
+   while ((c = getopt_long(argc, argv, "vc:d:p:i:o:C:D:S:Z:L:E:M:J:P:B:N:T:m:R:W:r:w:x:K:l:t:F:z:A:O:Y:H:I:U:", long_opts, &opt_idx)) != -1)
       switch (c)
       {
 	 case 'v':
@@ -98,6 +164,119 @@ int main(int argc, char *argv[])
 	 case 'L':
 		 print_log = atoi(optarg);
 		 break;
+	 case 'E':
+		 engine = atoi(optarg);
+		 break;
+	 case 'M':
+		 print_speed = atoi(optarg);
+		 break;
+	 case 'J':
+		 jit_check = atoi(optarg);
+		 break;
+	 case 'P':
+		 print_pairs = atoi(optarg);
+		 break;
+	 case 'B':
+		 limits.cycles = strtoull(optarg, NULL, 0);
+		 break;
+	 case 'N':
+		 limits.instructions = strtoull(optarg, NULL, 0);
+		 break;
+	 case 'T':
+		 if ((sscanf(optarg, "%x", &watch_begin) != 1) ||
+				 (watch_begin > 0xFFFF))
+		 {
+			 printf("Target address out of range: %s\n", optarg);
+			 return -1;
+		 }
+		 limits.target = watch_begin;
+		 break;
+	 case 'm':
+		 map_files = atoi(optarg);
+		 break;
+	 case 'R':
+		 repeat = atoi(optarg);
+		 break;
+	 case 'W':
+		 save_written = atoi(optarg);
+		 break;
+	 case 'r':
+	 case 'w':
+	 case 'x':
+		 // begin-end or a single address, in hex
+		 if (sscanf(optarg, "%x-%x", &watch_begin, &watch_end) < 2)
+		 {
+			 watch_end = watch_begin;
+		 }
+		 if ((watch_begin > watch_end) || (watch_end > 0xFFFF))
+		 {
+			 printf("Watch address out of range: %s\n", optarg);
+			 return -1;
+		 }
+		 add_watchpoint(&limits, watch_begin, watch_end,
+			 (c == 'r') ? WATCH_READ : ((c == 'w') ? WATCH_WRITE : WATCH_EXEC), 1);
+		 break;
+	 case 'K':
+		 watch_log = atoi(optarg);
+		 break;
+	 case 'l':
+		 image_file = optarg;
+		 break;
+	 case 't':
+		 trace_name = optarg;
+		 break;
+	 case 'F':
+		 trace_mode = atoi(optarg);
+		 break;
+	 case 'z':
+		 trace_delta = atoi(optarg);
+		 break;
+	 case 'A':
+		 // begin-end or a single address, in hex
+		 if (sscanf(optarg, "%x-%x", &watch_begin, &watch_end) < 2)
+		 {
+			 watch_end = watch_begin;
+		 }
+		 if ((watch_begin > watch_end) || (watch_end > 0xFFFF))
+		 {
+			 printf("Trace address out of range: %s\n", optarg);
+			 return -1;
+		 }
+		 filter_pc(&filter, watch_begin, watch_end);
+		 use_filter = 1;
+		 break;
+	 case 'O':
+		 // Group names separated by commas
+		 for (group = strtok(optarg, ","); group != NULL;
+				 group = strtok(NULL, ","))
+		 {
+			 if (op_group(group) == 0)
+			 {
+				 printf("Unknown opcode group: %s\n", group);
+				 return -1;
+			 }
+			 filter_ops(&filter, op_group(group));
+		 }
+		 use_filter = 1;
+		 break;
+	 case 'Y':
+		 // start-stop or just a start
+		 cycle_end = 0;
+		 if (sscanf(optarg, "%llu-%llu", &cycle_begin, &cycle_end) >= 1)
+		 {
+			 filter_cycles(&filter, cycle_begin, cycle_end);
+			 use_filter = 1;
+		 }
+		 break;
+	 case 'H':
+		 print_profile = atoi(optarg);
+		 break;
+	 case 'I':
+		 profile_every = strtoull(optarg, NULL, 0);
+		 break;
+	 case 'U':
+		 profile_file = optarg;
+		 break;
       }
 
 	// Create processor and memory
@@ -106,57 +285,137 @@ int main(int argc, char *argv[])
 	initialize_bus(&bus);
 	initialize_cpu(&cpu, &bus);
 
-	// Load code, bail out on error
-	r = import_mem(code_file, &bus, code);
-	switch (r)
+	// Load an image if given, or the code and data files
+	if (image_file != NULL)
 	{
-		case 0:
-			printf("Loading %s at 0x%04x\n", code_file, code);
-			break;
-		case -1:
-			printf("Error opening code file: %s\n", code_file);
-			return -1;
-			break;
-		case -2:
-			printf("Error reading code file: %s\n", code_file);
-			return -1;
-			break;
-		default:
-			printf("Code file error\n");
-			return -1;
-			break;
+		r = load_image(image_file, &bus, &image);
+		switch (r)
+		{
+			case 0:
+				printf("Loading %d segments (%ld bytes) from %s\n",
+					image.segments, image.bytes, image_file);
+				break;
+			case -1:
+				printf("Error opening image file: %s\n", image.file);
+				return -1;
+				break;
+			case -2:
+				printf("Error reading image file: %s line %d\n", image.file,
+					image.line);
+				return -1;
+				break;
+			case -3:
+				printf("Image doesn't fit in memory: %s line %d\n", image.file,
+					image.line);
+				return -1;
+				break;
+			default:
+				printf("Unknown image format or label: %s line %d\n",
+					image.file, image.line);
+				return -1;
+				break;
+		}
+
+		// Start where the image says, if it does
+		if (image.entry >= 0)
+		{
+			code = image.entry;
+		}
 	}
+	else
+	{
+		// Load code, bail out on error
+		// 	Mapped if asked for, read in if not or if it can't be mapped
+		r = -4;
+		if (map_files == 1)
+		{
+			r = map_image(code_file, &bus, code, MAP_COPY_ON_WRITE);
+		}
+		if (r <= -3)
+		{
+			r = import_mem(code_file, &bus, code);
+		}
+		switch (r)
+		{
+			case 0:
+				printf("Loading %s at 0x%04x\n", code_file, code);
+				break;
+			case -1:
+				printf("Error opening code file: %s\n", code_file);
+				return -1;
+				break;
+			case -2:
+				printf("Error reading code file: %s\n", code_file);
+				return -1;
+				break;
+			case -3:
+				printf("Code file doesn't fit at 0x%04x: %s\n", code, code_file);
+				return -1;
+				break;
+			default:
+				printf("Code file error\n");
+				return -1;
+				break;
+		}
 
-	// Load data if found
-	r = import_mem(data_file, &bus, data);
-	switch (r)
+		// Load data if found
+		r = -4;
+		if (map_files == 1)
+		{
+			r = map_image(data_file, &bus, data, MAP_COPY_ON_WRITE);
+		}
+		if (r <= -3)
+		{
+			r = import_mem(data_file, &bus, data);
+		}
+		switch (r)
+		{
+			case 0:
+				printf("Loading %s at 0x%04x\n", data_file, data);
+				break;
+			case -1:
+				printf("No data file found\n");
+				break;
+			case -2:
+				printf("Error reading data file: %s\n", data_file);
+				return -1;
+				break;
+			case -3:
+				printf("Data file doesn't fit at 0x%04x: %s\n", data, data_file);
+				return -1;
+				break;
+			default:
+				printf("Data file error\n");
+				return -1;
+				break;
+		}
+	}
+
+	// The output file can be the data pages, so it is written as they are
+	// 	If it can't be mapped, it is saved at the end instead
+	if ((map_files == 1) && (data_pages > 0) && (save_written == 0))
 	{
-		case 0:
-			printf("Loading %s at 0x%04x\n", data_file, data);
-			break;
-		case -1:
-			printf("No data file found\n");
-			break;
-		case -2:
-			printf("Error reading data file: %s\n", data_file);
-			return -1;
-			break;
-		default:
-			printf("Data file error\n");
-			return -1;
-			break;
+		if (map_output(out_file, &bus, data, data_pages) == 0)
+		{
+			printf("Mapping %s at 0x%04x\n", out_file, data);
+			out_mapped = 1;
+		}
+		else
+		{
+			printf("Can't map %s, saving at the end\n", out_file);
+		}
 	}
 
 	// Set code location here so reset can find it.
 	// A full 64k ROM would presumably provide this.
-	write(bus, 0xFFFC, code & 0xFF);
-	write(bus, 0xFFFD, code >> 8);
+	write(&bus, 0xFFFC, code & 0xFF);
+	write(&bus, 0xFFFD, code >> 8);
 
 	// Write protect the reset/irq vectors
 	// 	Note, the code isn't protected, so self-modifying code is possible
-	add_block(&bus.ro_blocks, 0xFFFA, 0xFFFF);
+	add_block(&bus, PG_RO, 0xFFFA, 0xFFFF);
 
-	// Read protect output peripherals
+	// Attach peripherals here with add_device
 
 	// "Boot"
 	reset(&cpu);
@@ -173,31 +432,190 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	// A binary trace takes the place of the code log
+	if (trace_name != NULL)
+	{
+		print_log = 1;
+	}
+
+	// Only the table engine builds an opreturn for the code log
+	if ((engine != ENGINE_TABLE) && (print_log == 1))
+	{
+		printf("\nCode log requires the table engine, using it instead\n");
+		engine = ENGINE_TABLE;
+	}
+
+	// Same for the pair profile
+	if ((engine != ENGINE_TABLE) && (print_pairs == 1))
+	{
+		printf("\nPair profile requires the table engine, using it instead\n");
+		engine = ENGINE_TABLE;
+	}
+
+	// And for the guest profile, counted by the trace or sampled by run()
+	if ((engine != ENGINE_TABLE) && (print_profile == 1))
+	{
+		printf("\nGuest profile requires the table engine, using it instead\n");
+		engine = ENGINE_TABLE;
+	}
+
+	// And for limits on the run
+	if ((engine != ENGINE_TABLE) && ((limits.cycles != 0) ||
+			(limits.instructions != 0) || (limits.target >= 0) ||
+			(limits.watchpoints != NULL)))
+	{
+		printf("\nRun limits require the table engine, using it instead\n");
+		engine = ENGINE_TABLE;
+	}
+
+	// Trace each instruction for the code log, pair profile and an exact
+	// 	guest profile
+	trace.print_log = print_log;
+	trace.bin = NULL;
+	trace.filter = (use_filter == 1) ? &filter : NULL;
+	trace.pairs = NULL;
+	trace.prev_op = -1;
+	trace.prev_next = 0;
+	trace.prof = NULL;
+	if (print_pairs == 1)
+	{
+		trace.pairs = calloc(256, sizeof(*trace.pairs));
+	}
+	if (print_profile == 1)
+	{
+		if (init_profile(&prof, cpu.PC, profile_every) != 0)
+		{
+			printf("Can't allocate the guest profile\n");
+			return -1;
+		}
+		trace.prof = &prof;
+
+		// Sampled every so many instructions, or each one counted
+		if (profile_every > 0)
+		{
+			limits.sample = sample_op;
+			limits.sample_every = profile_every;
+		}
+	}
+	limits.trace_ctx = &trace;
+	if ((print_log == 1) || (print_pairs == 1) ||
+			((print_profile == 1) && (profile_every == 0)))
+	{
+		limits.trace = trace_op;
+	}
+	if (trace_name != NULL)
+	{
+		r = open_trace(trace_name, &bin_trace, trace_mode,
+			(trace_delta == 1) ? TRACE_DELTA : TRACE_RAW);
+		if (r != 0)
+		{
+			printf("Error opening trace file: %s\n", trace_name);
+			return -1;
+		}
+		trace.bin = &bin_trace;
+	}
+
+	// Watchpoints log each hit and carry on, or stop at the first
+	limits.watch_log = log_watch;
+	for (watchpoint *wp = limits.watchpoints; wp != NULL; wp = wp->next)
+	{
+		wp->stop = (watch_log == 0);
+	}
+
+#ifndef RECOMPILED
+	// Only em6502r has a program built in
+	if (engine == ENGINE_RECOMPILED)
+	{
+		printf("\nNo recompiled program in this build, using the table engine\n");
+		engine = ENGINE_TABLE;
+	}
+#endif
+
+	// Save the loaded machine to go back to between runs
+	if (repeat > 1)
+	{
+		snap = malloc(sizeof(snapshot));
+		save_snapshot(&cpu, snap);
+	}
+
+	// Track the pages written from here on
+	// 	A snapshot has already started, and restoring it starts again
+	if (save_written == 1)
+	{
+		clear_dirty(&bus);
+	}
+
 	// Read & execute from the code segment until out of instructions
 	printf("\nExecuting . . . \n");
-	do 
+	start_time = clock();
+	for (int i = 0; i < repeat; i++)
+	{
+		// Later runs start from the snapshot instead of reloading
+		if (i > 0)
+		{
+			restore_snapshot(&cpu, snap);
+		}
+
+		// Each run starts back at the root of the call tree
+		if (trace.prof != NULL)
+		{
+			profile_start(&prof, &cpu);
+		}
+
+		if (engine == ENGINE_THREADED)
+		{
+			run_threaded(&cpu, &cycle_count, &instruction_count);
+		}
+		else if (engine == ENGINE_BLOCK)
+		{
+			run_blocks(&cpu, &cycle_count, &instruction_count);
+		}
+		else if (engine == ENGINE_JIT)
+		{
+			r = run_jit(&cpu, &cycle_count, &instruction_count, jit_check);
+			if (r != 0)
+			{
+				printf("JIT results differ from the table engine\n");
+				return -1;
+			}
+		}
+#ifdef RECOMPILED
+		else if (engine == ENGINE_RECOMPILED)
+		{
+			run_recompiled(&cpu, &cycle_count, &instruction_count);
+		}
+#endif
+		else
+		{
+			// Until a BRK, or a limit if any were given
+			r = run(&cpu, &limits, &cycle_count, &instruction_count);
+			if (r != RUN_BRK)
+			{
+				printf("\nStopped: %s\n", run_reason(r));
+			}
+		}
+	}
+	end_time = clock();
+
+	if (trace.bin != NULL)
 	{
-		// Log operation to stdout if enabled
-		if (print_log == 1)
+		if (close_trace(trace.bin) != 0)
 		{
-			log_PC(&cpu);
+			printf("Error writing trace file: %s\n", trace_name);
 		}
-		
-		cpu.IR = read(bus, cpu.PC);
-		opr = execute[cpu.IR](&cpu);
-		cycle_count += opr.cycles;
 
-		// Log operation to stdout if enabled
-		if (print_log == 1)
+		// Say if the trace writer held up the run, or lost records
+		if (bin_trace.stalls > 0)
 		{
-			log_op(&cpu, opr);
+			printf("\nTrace writer fell behind, waited for it %llu times\n",
+				bin_trace.stalls);
 		}
-		
-		// Execute peripheral code here
-		
-		// Execute IRQs here
-		
-	} while (cpu.IR != 0x00);
+		if (bin_trace.dropped > 0)
+		{
+			printf("\nTrace writer fell behind, dropped %llu records\n",
+				bin_trace.dropped);
+		}
+	}
 
 
 	// Print new status
@@ -216,7 +634,7 @@ int main(int argc, char *argv[])
 		print_mem_page(&bus, stack, cpu.SP);
 	}
 
-	// Print and save requested data pages
+	// Print requested data pages
 	if (data_pages > 0)
 	{
 		printf("\nData:\n");
@@ -224,36 +642,95 @@ int main(int argc, char *argv[])
 		{
 			print_mem_page(&bus, data + i*0x100, -1);
 		}
-		r = export_mem(out_file, &bus, data, data_pages);
-		switch (r)
+	}
+
+	// Save the data pages, or every page the program wrote
+	r = 0;
+	if (save_written == 1)
+	{
+		r = export_mem(out_file, &bus, 0, NUM_PAGES, EXPORT_DIRTY);
+	}
+	else if ((data_pages > 0) && (out_mapped == 0))
+	{
+		r = export_mem(out_file, &bus, data, data_pages, EXPORT_ALL);
+	}
+	switch (r)
+	{
+		case 0:
+			if (save_written == 1)
+			{
+				printf("Saving %d written pages in %s\n",
+					count_dirty(&bus, 0, NUM_PAGES), out_file);
+			}
+			else if (data_pages > 0)
+			{
+				printf("Saving 0x%04x in %s\n", data, out_file);
+			}
+			break;
+		case -1:
+			printf("Error opening output file: %s\n", out_file);
+			return -1;
+			break;
+		case -2:
+			printf("Error writing output file: %s\n", out_file);
+			return -1;
+			break;
+		default:
+			printf("Output file error\n");
+			return -1;
+			break;
+	}
+
+	// print cycles used
+	printf("\nCycles: %llu\n", cycle_count);
+
+	// print emulation speed if requested
+	if (print_speed == 1)
+	{
+		double seconds = (double)(end_time - start_time) / CLOCKS_PER_SEC;
+
+		printf("Instructions: %llu\n", instruction_count);
+		printf("Time: %.3f s\n", seconds);
+		if (seconds > 0)
+		{
+			printf("MIPS: %.2f\n", instruction_count / seconds / 1e6);
+		}
+	}
+
+	// print the most common opcode pairs if requested
+	if (trace.pairs != NULL)
+	{
+		print_pairs_profile(trace.pairs, PAIR_PROFILE_SIZE);
+		free(trace.pairs);
+	}
+
+	// print the guest hot spots and save the call stacks if requested
+	if (trace.prof != NULL)
+	{
+		print_hotspots(&prof, PROFILE_HOT_SIZE);
+		switch (write_collapsed(&prof, profile_file))
 		{
 			case 0:
-				printf("Saving 0x%04x in %s\n", data, out_file);
+				printf("Saving call stacks in %s\n", profile_file);
 				break;
 			case -1:
-				printf("Error opening output file: %s\n", out_file);
-				return -1;
-				break;
-			case -2:
-				printf("Error writing output file: %s\n", out_file);
-				return -1;
+				printf("Error opening profile file: %s\n", profile_file);
 				break;
 			default:
-				printf("Output file error\n");
-				return -1;
+				printf("Error writing profile file: %s\n", profile_file);
 				break;
 		}
+		free_profile(&prof);
 	}
 
-	// print cycles used
-	printf("\nCycles: %d\n", cycle_count);
-
    return 0;
 }
 
 void print_registers(CPU *cpu)
 // List contents of CPU on stdout
 {
+	update_SR(cpu);
+
 	printf("\n");
 	printf("6502 CPU Status:\n");
 	printf("PC: 0x%04X\n", cpu->PC);
@@ -279,7 +756,7 @@ void print_mem_page(membus *bus, word addr, int mark)
 		for (int col = 0; col < 16; col++)
 		{
 			int offset = row * 16 + col;
-			printf("%02X", bus->mem[addr + offset]);
+			printf("%02X", peek(bus, addr + offset));
 			if (offset == mark)
 			{
 				printf("* ");
@@ -293,53 +770,109 @@ void print_mem_page(membus *bus, word addr, int mark)
 	}
 }
 
-void log_PC(CPU *cpu)
+void print_pairs_profile(unsigned long long (*pairs)[256], int n)
+// Print the n most common opcode pairs, most common first
+// 	Each line is an entry for fusedpairs.h followed by its count
 {
-	printf("0x%04X ", cpu->PC);
+	printf("\nOpcode pairs:\n");
+	for (int i = 0; i < n; i++)
+	{
+		unsigned long long most = 0;
+		int first = 0, second = 0;
+
+		for (int a = 0; a < 256; a++)
+		{
+			for (int b = 0; b < 256; b++)
+			{
+				if (pairs[a][b] > most)
+				{
+					most = pairs[a][b];
+					first = a;
+					second = b;
+				}
+			}
+		}
+
+		if (most == 0)
+		{
+			break;
+		}
+		printf("\tFUSE(%02X, %02X)\t// %llu\n", first, second, most);
+		pairs[first][second] = 0;
+	}
 }
 
-void log_op(CPU *cpu, struct opreturn opr)
+void trace_op(void *trace_ctx, CPU *cpu, word addr, struct opreturn opr)
+// Code log, pair profile and guest profile for one instruction, called by
+// 	run()
 {
-	printf("%-9s ", opr.mnemonic);
+	trace_state *trace = trace_ctx;
 
-	if (opr.bytes == 1)
+	// Log operation to the trace file, or to stdout if enabled, if it
+	// 	passes the filter
+	if (((trace->bin != NULL) || (trace->print_log == 1)) &&
+			((trace->filter == NULL) ||
+			 filter_pass(trace->filter, addr, cpu->IR, opr.cycles)))
 	{
-		printf("(%d byte)  ", opr.bytes);
-	}
-	else
-	{
-		printf("(%d bytes) ", opr.bytes);
-	}
+		update_SR(cpu);
+		cpu->TC = opr.cycles;
 
-	for (cpu->TC = 0; cpu->TC < opr.cycles; cpu->TC++)
-	{
-		printf(" .");
+		if (trace->bin != NULL)
+		{
+			trace_add(trace->bin, addr, cpu->IR, opr.operand, opr.result,
+				cpu->SR, opr.bytes, opr.cycles);
+		}
+		else
+		{
+			trace_record rec;
+
+			rec.pc = addr;
+			rec.operand = opr.operand;
+			rec.op = cpu->IR;
+			rec.result = opr.result;
+			rec.sr = cpu->SR;
+			rec.size = (opr.bytes << 4) | opr.cycles;
+			print_record(stdout, &rec, opr.mnemonic);
+		}
 	}
-	for (cpu->TC = opr.cycles - 1; cpu->TC < 7; cpu->TC++)
+	else if (trace->bin != NULL)
 	{
-		printf("  ");
+		// Left out by the filter, the trace still counts its cycles
+		trace_skip(trace->bin, opr.cycles);
 	}
 
-	if (opr.bytes == 1)
+	// Count pairs where the second instruction follows the first
+	if (trace->pairs != NULL)
 	{
-		printf("       0x%02X", opr.result);
-	}
-	else
-	{
-		if (opr.operand <= 0xFF)
-		{
-			printf("  0x%02X 0x%02X", opr.operand, opr.result);
-		}
-		else
+		if ((trace->prev_op >= 0) && (trace->prev_next == addr))
 		{
-			printf("0x%04X 0x%02X", opr.operand, opr.result);
+			trace->pairs[trace->prev_op][cpu->IR]++;
 		}
+		trace->prev_op = cpu->IR;
+		trace->prev_next = addr + opr.bytes;
+	}
+
+	// Count every instruction for the guest profile, whatever the filter
+	if ((trace->prof != NULL) && (trace->prof->every == 0))
+	{
+		profile_op(trace->prof, addr, cpu->IR, opr.operand, opr.cycles);
 	}
+}
 
-	printf(" %c%c%c%c%c%c%c%c", cpu->SR & N ? 'N' : '.', 
-			cpu->SR & V ? 'V' : '.', '.', cpu->SR & B ? 'B' : '.', 
-			cpu->SR & D ? 'D' : '.', cpu->SR & I ? 'I' : '.',
-			cpu->SR & Z ? 'Z' : '.', cpu->SR & C ? 'C' : '.');
+void log_watch(void *trace_ctx, CPU *cpu, word addr, int type)
+// One line for a watched access, called by run()
+// 	Writes show the value written, reads and execution what's there
+{
+	const char *name = (type == WATCH_READ) ? "read" :
+		((type == WATCH_WRITE) ? "write" : "exec");
 
-	printf("\n");
+	printf("Watch: %-5s 0x%04X = 0x%02X\n", name, addr, peek(cpu->bus, addr));
+}
+
+void sample_op(void *trace_ctx, CPU *cpu, unsigned long long cycles)
+// One sample for the guest profile, called by run()
+{
+	trace_state *trace = trace_ctx;
+
+	profile_sample(trace->prof, cpu, cycles);
 }
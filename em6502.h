@@ -7,6 +7,8 @@
 #include "cpu.h"
 #include "instructions.h"
 #include "membus.h"
+#include "profile.h"
+#include "trace.h"
 
 #ifndef EM6502_H
 #define EM6502_H
@@ -15,13 +17,34 @@
 #define DEF_DATA_ADDR 0x0200
 #define DEF_CODE_ADDR 0x0600
 
-// Get array of instruction functions
-extern struct opreturn (*execute[])(CPU *cpu);
+// Execution engines
+#define ENGINE_TABLE 0		// instruction function tables, supports code log
+#define ENGINE_THREADED 1	// threaded code with computed goto dispatch
+#define ENGINE_BLOCK 2		// cache of predecoded basic blocks
+#define ENGINE_JIT 3			// x86-64 translation, block cache elsewhere
+#define ENGINE_RECOMPILED 4	// program translated to C by em6502rc
+
+// Number of opcode pairs printed by the pair profile
+#define PAIR_PROFILE_SIZE 16
+
+// Code log, pair profile and guest profile, passed to trace_op by run()
+typedef struct trace_state
+{
+	int print_log;							// 1 to print the code log
+	trace_file *bin;						// binary trace in place of it, or NULL
+	trace_filter *filter;				// what goes in either, NULL for all
+	unsigned long long (*pairs)[256];	// pair counts [first][second], or NULL
+	int prev_op;							// last opcode, -1 before the first
+	word prev_next;						// address after the last instruction
+	profile *prof;							// guest profile, or NULL
+} trace_state;
 
 // IO functions
 void print_registers(CPU *cpu);
 void print_mem_page(membus *mem, word addr, int mark);
-void log_PC(CPU *cpu);
-void log_op(CPU *cpu, struct opreturn opr);
+void print_pairs_profile(unsigned long long (*pairs)[256], int n);
+void trace_op(void *trace_ctx, CPU *cpu, word addr, struct opreturn opr);
+void log_watch(void *trace_ctx, CPU *cpu, word addr, int type);
+void sample_op(void *trace_ctx, CPU *cpu, unsigned long long cycles);
 
 #endif
@@ -0,0 +1,38 @@
+// fusedbodies.h
+//
+// Definitions for 6502 emulator program
+// 	Fused instruction pair bodies for the block cache engine
+//
+// Brian K. Niece
+//
+// No include guard, this is included in the middle of run_blocks(), the
+// 	same as opbodies.h.  Each body is the two bodies from opbodies.h
+// 	joined by THEN, which finishes the first instruction (PC and
+// 	cycles) and moves the operand macros on to the second, so cycle
+// 	counts and results are the same as running them one at a time.
+// 	The pairs are listed in fusedpairs.h.
+
+	FUSED(08, 68)	PUSH(SR | B);	THEN(1, 3);	PULL(A); SET_NZ(A);		NEXT(1, 4);
+	FUSED(29, D0)	M = OPR8; DO_AND;	THEN(2, 2);	BRANCH((SR & Z) == 0);
+	FUSED(A5, 45)	EA_ZPG; M = RDZ(addr); DO_LOAD(A);	THEN(2, 3);
+						EA_ZPG; M = RDZ(addr); DO_EOR;			NEXT(2, 3);
+	FUSED(AD, 4D)	EA_ABS; M = RD(addr); DO_LOAD(A);	THEN(3, 4);
+						EA_ABS; M = RD(addr); DO_EOR;			NEXT(3, 4);
+	FUSED(A5, 65)	EA_ZPG; M = RDZ(addr); DO_LOAD(A);	THEN(2, 3);
+						EA_ZPG; M = RDZ(addr); DO_ADC;			NEXT(2, 3);
+	FUSED(68, 85)	PULL(A); SET_NZ(A);	THEN(1, 4);	EA_ZPG; WR(addr, A);	NEXT(2, 3);
+	FUSED(68, 8D)	PULL(A); SET_NZ(A);	THEN(1, 4);	EA_ABS; WR(addr, A);	NEXT(3, 4);
+	FUSED(A9, 85)	M = OPR8; DO_LOAD(A);	THEN(2, 2);	EA_ZPG; WR(addr, A);	NEXT(2, 3);
+	FUSED(A9, 8D)	M = OPR8; DO_LOAD(A);	THEN(2, 2);	EA_ABS; WR(addr, A);	NEXT(3, 4);
+	FUSED(A5, 85)	EA_ZPG; M = RDZ(addr); DO_LOAD(A);	THEN(2, 3);
+						EA_ZPG; WR(addr, A);						NEXT(2, 3);
+	FUSED(AD, 8D)	EA_ABS; M = RD(addr); DO_LOAD(A);	THEN(3, 4);
+						EA_ABS; WR(addr, A);						NEXT(3, 4);
+	FUSED(C9, D0)	M = OPR8; DO_CMP(A);	THEN(2, 2);	BRANCH((SR & Z) == 0);
+	FUSED(E4, D0)	EA_ZPG; M = RDZ(addr); DO_CMP(X);	THEN(2, 3);
+						BRANCH((SR & Z) == 0);
+	FUSED(CA, D0)	X--; SET_NZ(X);	THEN(1, 2);	BRANCH((SR & Z) == 0);
+	FUSED(88, D0)	Y--; SET_NZ(Y);	THEN(1, 2);	BRANCH((SR & Z) == 0);
+	FUSED(E8, E4)	X++; SET_NZ(X);	THEN(1, 2);
+						EA_ZPG; M = RDZ(addr); DO_CMP(X);			NEXT(2, 3);
+	FUSED(C8, C0)	Y++; SET_NZ(Y);	THEN(1, 2);	M = OPR8; DO_CMP(Y);	NEXT(2, 2);
@@ -0,0 +1,33 @@
+// fusedpairs.h
+//
+// Definitions for 6502 emulator program
+// 	Opcode pairs the block cache runs as one fused micro-op
+//
+// Brian K. Niece
+//
+// No include guard, this is a list included wherever the pairs are
+// 	needed, after defining FUSE(first, second).  Each pair also needs a
+// 	body in fusedbodies.h.
+//
+// The list comes from the pair profile, em6502 -P 1, run over the
+// 	sample programs, which prints lines in this same form.  A pair is
+// 	only fused inside a block, so a first instruction that ends a block
+// 	(branch, jump, return or BRK) is never fused.
+
+	FUSE(08, 68)	// PHP, PLA
+	FUSE(29, D0)	// AND #, BNE
+	FUSE(A5, 45)	// LDA zpg, EOR zpg
+	FUSE(AD, 4D)	// LDA abs, EOR abs
+	FUSE(A5, 65)	// LDA zpg, ADC zpg
+	FUSE(68, 85)	// PLA, STA zpg
+	FUSE(68, 8D)	// PLA, STA abs
+	FUSE(A9, 85)	// LDA #, STA zpg
+	FUSE(A9, 8D)	// LDA #, STA abs
+	FUSE(A5, 85)	// LDA zpg, STA zpg
+	FUSE(AD, 8D)	// LDA abs, STA abs
+	FUSE(C9, D0)	// CMP #, BNE
+	FUSE(E4, D0)	// CPX zpg, BNE
+	FUSE(CA, D0)	// DEX, BNE
+	FUSE(88, D0)	// DEY, BNE
+	FUSE(E8, E4)	// INX, CPX zpg
+	FUSE(C8, C0)	// INY, CPY #
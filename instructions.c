@@ -9,6 +9,29 @@
 // 	not in opcode order like in the header
 
 #include "instructions.h"
+#include "bcd.h"
+
+static inline void adc_bcd(CPU *cpu, byte M)
+// Add with Carry in BCD mode, shared by all of the addressing modes
+// 	A, C = A + M + C
+{
+	word r = bcd_adc_table[cpu->SR & C][cpu->A][M];
+
+	cpu->A = r & 0xFF;
+	cpu->SR = (cpu->SR & ~(N | V | Z | C)) | (r >> 8);
+	cpu->lazy &= ~(N | V | Z);
+}
+
+static inline void sbc_bcd(CPU *cpu, byte M)
+// Subtract with Carry in BCD mode, shared by all of the addressing modes
+// 	A, C = A + ~M + C
+{
+	word r = bcd_sbc_table[cpu->SR & C][cpu->A][M];
+
+	cpu->A = r & 0xFF;
+	cpu->SR = (cpu->SR & ~(N | V | Z | C)) | (r >> 8);
+	cpu->lazy &= ~(N | V | Z);
+}
 
 struct opreturn do_ADC_imm(CPU *cpu)
 // Add with Carry, immediate addressing
@@ -27,7 +50,7 @@ struct opreturn do_ADC_imm(CPU *cpu)
 	// 	Do the addition and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	int result = cpu->A + M + ((cpu->SR & C)?1:0);
@@ -59,18 +82,18 @@ struct opreturn do_ADC_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the addition and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A + M + ((cpu->SR & C)?1:0);
 	set_C(cpu, result);
@@ -104,12 +127,12 @@ struct opreturn do_ADC_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -117,7 +140,7 @@ struct opreturn do_ADC_absX(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -127,7 +150,7 @@ struct opreturn do_ADC_absX(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the addition and update C
@@ -166,12 +189,12 @@ struct opreturn do_ADC_absY(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add Y to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -179,7 +202,7 @@ struct opreturn do_ADC_absY(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -189,7 +212,7 @@ struct opreturn do_ADC_absY(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the addition and update C
@@ -225,14 +248,14 @@ struct opreturn do_ADC_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the addition and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A + M + ((cpu->SR & C)?1:0);
 	set_C(cpu, result);
@@ -263,7 +286,7 @@ struct opreturn do_ADC_zpgX(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
@@ -273,7 +296,7 @@ struct opreturn do_ADC_zpgX(CPU *cpu)
 	// 	Do the addition and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A + M + ((cpu->SR & C)?1:0);
 	set_C(cpu, result);
@@ -304,25 +327,25 @@ struct opreturn do_ADC_Xind(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5: fetch byte
 	// 	Do the addition and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A + M + ((cpu->SR & C)?1:0);
 	set_C(cpu, result);
@@ -355,22 +378,22 @@ struct opreturn do_ADC_indY(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, fetch byte and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -380,7 +403,7 @@ struct opreturn do_ADC_indY(CPU *cpu)
 
 		// Cycle 5:  fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 
 	// 	Do the addition and update C
@@ -418,7 +441,7 @@ struct opreturn do_AND_imm(CPU *cpu)
 	// 	Do the AND operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	int result = cpu->A & M;
@@ -448,18 +471,18 @@ struct opreturn do_AND_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the AND operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A & M;
 
@@ -491,12 +514,12 @@ struct opreturn do_AND_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -504,7 +527,7 @@ struct opreturn do_AND_absX(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -514,7 +537,7 @@ struct opreturn do_AND_absX(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the AND operation
@@ -551,12 +574,12 @@ struct opreturn do_AND_absY(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add Y to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -564,7 +587,7 @@ struct opreturn do_AND_absY(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -574,7 +597,7 @@ struct opreturn do_AND_absY(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the AND operation
@@ -608,14 +631,14 @@ struct opreturn do_AND_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the AND operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A & M;
 
@@ -644,7 +667,7 @@ struct opreturn do_AND_zpgX(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
@@ -654,7 +677,7 @@ struct opreturn do_AND_zpgX(CPU *cpu)
 	// 	Do the AND operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A & M;
 
@@ -683,25 +706,25 @@ struct opreturn do_AND_Xind(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5: fetch byte
 	// 	Do the AND operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A & M;
 
@@ -732,22 +755,22 @@ struct opreturn do_AND_indY(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, fetch byte and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -757,7 +780,7 @@ struct opreturn do_AND_indY(CPU *cpu)
 
 		// Cycle 5:  fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 
 	// 	Do the AND operation
@@ -822,15 +845,15 @@ struct opreturn do_ASL_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 4: Copy bit 7 (N) to carry and shift left
 	if ((M & N) == 0)
@@ -848,7 +871,7 @@ struct opreturn do_ASL_abs(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -870,12 +893,12 @@ struct opreturn do_ASL_absX(CPU *cpu)
 	
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -888,7 +911,7 @@ struct opreturn do_ASL_absX(CPU *cpu)
 
 	// Cycle 4: fetch byte
 	word addr = (bah << 8) + bal;
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 5: Copy bit 7 (N) to carry and shift left
 	if ((M & N) == 0)
@@ -906,7 +929,7 @@ struct opreturn do_ASL_absX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 6: Store back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -927,11 +950,11 @@ struct opreturn do_ASL_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 3: Copy bit 7 (N) to carry and shift left
 	if ((M & N) == 0)
@@ -949,7 +972,7 @@ struct opreturn do_ASL_zpg(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 4: Store back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -970,14 +993,14 @@ struct opreturn do_ASL_zpgX(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 4: Copy bit 7 (N) to carry and shift left
 	if ((M & N) == 0)
@@ -995,7 +1018,7 @@ struct opreturn do_ASL_zpgX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -1016,7 +1039,7 @@ struct opreturn do_BCC_rel(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	//	Add offset to program counter if C = 0
@@ -1072,7 +1095,7 @@ struct opreturn do_BCS_rel(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	//	Add offset to program counter if C = 1
@@ -1128,12 +1151,12 @@ struct opreturn do_BEQ_rel(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	//	Add offset to program counter if Z = 1
 	//		Branch adds 1 cycle		
-	if ((cpu->SR & Z) == Z)
+	if ((get_SR(cpu) & Z) == Z)
 	{
 		opr.cycles += 1;
 
@@ -1185,21 +1208,22 @@ struct opreturn do_BIT_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the AND operation
 	// 	Set N,V,Z as necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A & M;
 
 	set_N(cpu, M);
+	update_SR(cpu);
 	if ((M & V) == 0)
 	{
 		cpu->SR &= ~V;
@@ -1230,17 +1254,18 @@ struct opreturn do_BIT_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the AND operation
 	// 	Set N,V,Z as necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A & M;
 
 	set_N(cpu, M);
+	update_SR(cpu);
 	if ((M & V) == 0)
 	{
 		cpu->SR &= ~V;
@@ -1270,12 +1295,12 @@ struct opreturn do_BMI_rel(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	//	Add offset to program counter if N = 1
 	//		Branch adds 1 cycle		
-	if ((cpu->SR & N) == N)
+	if ((get_SR(cpu) & N) == N)
 	{
 		opr.cycles += 1;
 
@@ -1326,12 +1351,12 @@ struct opreturn do_BNE_rel(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	//	Add offset to program counter if Z = 0
 	//		Branch adds 1 cycle		
-	if ((cpu->SR & Z) == 0)
+	if ((get_SR(cpu) & Z) == 0)
 	{
 		opr.cycles += 1;
 
@@ -1382,12 +1407,12 @@ struct opreturn do_BPL_rel(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	//	Add offset to program counter if N = 0
 	//		Branch adds 1 cycle		
-	if ((cpu->SR & N) == 0)
+	if ((get_SR(cpu) & N) == 0)
 	{
 		opr.cycles += 1;
 
@@ -1438,6 +1463,9 @@ struct opreturn do_BRK_impl(CPU *cpu)
 	// Cycle 0: instruction fetched, increment PC
 	cpu->PC++;
 
+	// The program ends here, so leave every flag up to date
+	update_SR(cpu);
+
 	opr.operand = 0;
 	opr.result = 0;
 
@@ -1457,12 +1485,12 @@ struct opreturn do_BVC_rel(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	//	Add offset to program counter if V = 0
 	//		Branch adds 1 cycle		
-	if ((cpu->SR & V) == 0)
+	if ((get_SR(cpu) & V) == 0)
 	{
 		opr.cycles += 1;
 
@@ -1513,12 +1541,12 @@ struct opreturn do_BVS_rel(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	//	Add offset to program counter if V = 0
 	//		Branch adds 1 cycle		
-	if ((cpu->SR & V) == V)
+	if ((get_SR(cpu) & V) == V)
 	{
 		opr.cycles += 1;
 
@@ -1572,7 +1600,7 @@ struct opreturn do_CLC_impl(CPU *cpu)
 	cpu->SR &= ~C;
 
 	opr.operand = 0;
-	opr.result = cpu->SR;
+	opr.result = get_SR(cpu);
 
 	return opr;
 }
@@ -1593,12 +1621,31 @@ struct opreturn do_CLI_impl(CPU *cpu)
 	cpu->SR &= ~I;
 
 	opr.operand = 0;
-	opr.result = cpu->SR;
+	opr.result = get_SR(cpu);
 
 	return opr;
 }
 
-// CLD is below the execute array assignments
+struct opreturn do_CLD_impl(CPU *cpu)
+// Clear Decimal flag
+{
+	struct opreturn opr;
+
+	opr.bytes = 1;
+	opr.cycles = 2;
+	opr.mnemonic = "CLD   ";
+
+	// Cycle 0: instruction fetched, increment PC
+	cpu->PC++;
+
+	// Cycle 1: Clear D
+	cpu->SR &= ~D;
+
+	opr.operand = 0;
+	opr.result = get_SR(cpu);
+
+	return opr;
+}
 
 struct opreturn do_CLV_impl(CPU *cpu)
 // Clear Overflow flag
@@ -1613,10 +1660,11 @@ struct opreturn do_CLV_impl(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: Clear V
+	update_SR(cpu);
 	cpu->SR &= ~V;
 
 	opr.operand = 0;
-	opr.result = cpu->SR;
+	opr.result = get_SR(cpu);
 
 	return opr;
 }
@@ -1637,7 +1685,7 @@ struct opreturn do_CMP_imm(CPU *cpu)
 	// Cycle 1: fetch byte and increment PC
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	int result = cpu->A + (~M&0xFF) + 1;
@@ -1669,17 +1717,17 @@ struct opreturn do_CMP_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A + (~M&0xFF) + 1;
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -1713,12 +1761,12 @@ struct opreturn do_CMP_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -1726,7 +1774,7 @@ struct opreturn do_CMP_absX(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -1736,7 +1784,7 @@ struct opreturn do_CMP_absX(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the subtraction and update C
@@ -1773,12 +1821,12 @@ struct opreturn do_CMP_absY(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -1786,7 +1834,7 @@ struct opreturn do_CMP_absY(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -1796,7 +1844,7 @@ struct opreturn do_CMP_absY(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the subtraction and update C
@@ -1830,13 +1878,13 @@ struct opreturn do_CMP_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A + (~M&0xFF) + 1;
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -1867,7 +1915,7 @@ struct opreturn do_CMP_zpgX(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
@@ -1876,7 +1924,7 @@ struct opreturn do_CMP_zpgX(CPU *cpu)
 	// Cycle 3: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A + (~M&0xFF) + 1;
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -1907,24 +1955,24 @@ struct opreturn do_CMP_Xind(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A + (~M&0xFF) + 1;
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -1957,22 +2005,22 @@ struct opreturn do_CMP_indY(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, fetch byte and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -1982,7 +2030,7 @@ struct opreturn do_CMP_indY(CPU *cpu)
 
 		// Cycle 5:  fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 
 	// 	Do the subtraction and update C
@@ -2018,7 +2066,7 @@ struct opreturn do_CPX_imm(CPU *cpu)
 	// Cycle 1: fetch byte and increment PC
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	int result = cpu->X + (~M&0xFF) + 1;
@@ -2042,25 +2090,25 @@ struct opreturn do_CPX_abs(CPU *cpu)
 {
 	struct opreturn opr;
 
-	opr.bytes = 2;
-	opr.cycles = 2;
+	opr.bytes = 3;
+	opr.cycles = 4;
 	opr.mnemonic = "CPX abs";
 
 	// Cycle 0: instruction fetched, increment PC
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->X + (~M&0xFF) + 1;
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -2091,13 +2139,13 @@ struct opreturn do_CPX_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->X + (~M&0xFF) + 1;
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -2130,7 +2178,7 @@ struct opreturn do_CPY_imm(CPU *cpu)
 	// Cycle 1: fetch byte and increment PC
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	int result = cpu->Y + (~M&0xFF) + 1;
@@ -2154,25 +2202,25 @@ struct opreturn do_CPY_abs(CPU *cpu)
 {
 	struct opreturn opr;
 
-	opr.bytes = 2;
-	opr.cycles = 2;
+	opr.bytes = 3;
+	opr.cycles = 4;
 	opr.mnemonic = "CPY abs";
 
 	// Cycle 0: instruction fetched, increment PC
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->Y + (~M&0xFF) + 1;
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -2203,13 +2251,13 @@ struct opreturn do_CPY_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,Z if necessary
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->Y + (~M&0xFF) + 1;
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -2239,15 +2287,15 @@ struct opreturn do_DEC_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 4: Decrement byte
 	// 	set N,Z if necessary
@@ -2257,7 +2305,7 @@ struct opreturn do_DEC_abs(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store byte back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -2279,12 +2327,12 @@ struct opreturn do_DEC_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -2297,7 +2345,7 @@ struct opreturn do_DEC_absX(CPU *cpu)
 
 	// Cycle 4: fetch byte
 	word addr = (bah << 8) + bal;
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 5: Decrement byte
 	// 	set N,Z if necessary
@@ -2307,7 +2355,7 @@ struct opreturn do_DEC_absX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 6: Store byte back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -2328,11 +2376,11 @@ struct opreturn do_DEC_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 3: Decrement byte
 	// 	set N,Z if necessary
@@ -2342,7 +2390,7 @@ struct opreturn do_DEC_zpg(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 4: Store byte back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -2363,14 +2411,14 @@ struct opreturn do_DEC_zpgX(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 4: Decrement byte
 	// 	set N,Z if necessary
@@ -2380,7 +2428,7 @@ struct opreturn do_DEC_zpgX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store byte back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -2405,7 +2453,7 @@ struct opreturn do_EOR_imm(CPU *cpu)
 	// 	Do the XOR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	int result = cpu->A ^ M;
@@ -2435,18 +2483,18 @@ struct opreturn do_EOR_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the XOR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A ^ M;
 
@@ -2478,12 +2526,12 @@ struct opreturn do_EOR_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -2491,7 +2539,7 @@ struct opreturn do_EOR_absX(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -2501,7 +2549,7 @@ struct opreturn do_EOR_absX(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the XOR operation
@@ -2538,12 +2586,12 @@ struct opreturn do_EOR_absY(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add Y to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -2551,7 +2599,7 @@ struct opreturn do_EOR_absY(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -2561,7 +2609,7 @@ struct opreturn do_EOR_absY(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the XOR operation
@@ -2595,14 +2643,14 @@ struct opreturn do_EOR_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the XOR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A ^ M;
 
@@ -2631,7 +2679,7 @@ struct opreturn do_EOR_zpgX(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
@@ -2641,7 +2689,7 @@ struct opreturn do_EOR_zpgX(CPU *cpu)
 	// 	Do the XOR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A ^ M;
 
@@ -2670,25 +2718,25 @@ struct opreturn do_EOR_Xind(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5: fetch byte
 	// 	Do the XOR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A ^ M;
 
@@ -2719,22 +2767,22 @@ struct opreturn do_EOR_indY(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, fetch byte and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -2744,7 +2792,7 @@ struct opreturn do_EOR_indY(CPU *cpu)
 
 		// Cycle 5:  fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 
 	// 	Do the XOR operation
@@ -2776,15 +2824,15 @@ struct opreturn do_INC_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 4: Increment byte
 	// 	set N,Z if necessary
@@ -2794,7 +2842,7 @@ struct opreturn do_INC_abs(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store byte back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -2816,12 +2864,12 @@ struct opreturn do_INC_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -2834,7 +2882,7 @@ struct opreturn do_INC_absX(CPU *cpu)
 
 	// Cycle 4: fetch byte
 	word addr = (bah << 8) + bal;
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 5: Decrement byte
 	// 	set N,Z if necessary
@@ -2844,7 +2892,7 @@ struct opreturn do_INC_absX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 6: Store byte back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -2865,11 +2913,11 @@ struct opreturn do_INC_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 3: Decrement byte
 	// 	set N,Z if necessary
@@ -2879,7 +2927,7 @@ struct opreturn do_INC_zpg(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 4: Store byte back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -2900,14 +2948,14 @@ struct opreturn do_INC_zpgX(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 4: Decrement byte
 	// 	set N,Z if necessary
@@ -2917,7 +2965,7 @@ struct opreturn do_INC_zpgX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store byte back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -3038,12 +3086,12 @@ struct opreturn do_JMP_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	byte adl = read(*cpu->bus, cpu->PC);
+	byte adl = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
 	//		set PC for jump
-	byte adh = read(*cpu->bus, cpu->PC);
+	byte adh = read(cpu->bus, cpu->PC);
 	word addr = adl + (adh << 8);
 	cpu->PC++;
 	cpu->PC = addr;
@@ -3067,22 +3115,22 @@ struct opreturn do_JMP_ind(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address location, incement PC
-	byte all = read(*cpu->bus, cpu->PC);
+	byte all = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address location, increment PC
-	byte alh = read(*cpu->bus, cpu->PC);
+	byte alh = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 3: fetch low byte of address
-	byte adl = read(*cpu->bus, all + (alh << 8));
+	byte adl = read(cpu->bus, all + (alh << 8));
 
 	// Cycle 4: fetch high byte of address
 	//		set PC for jump
 	//		This will not cross page boundaries when all = 0xff -- normal 
 	//			behavior for a MOS 6502.
 	all = all + 1;
-	byte adh = read(*cpu->bus, all + (alh << 8));
+	byte adh = read(cpu->bus, all + (alh << 8));
 	word addr = adl + (adh << 8);
 	cpu->PC = addr;
 
@@ -3106,19 +3154,19 @@ struct opreturn do_JSR_abs(CPU *cpu)
 
 	// Cycle 1: push high byte of return address on stack, decrement SP
 	//    This is actually the final byte of the instruction
-	write(*cpu->bus, 0x100 + cpu->SP, (cpu->PC + 1) >> 8);
+	write_stack(cpu->bus, cpu->SP, (cpu->PC + 1) >> 8);
 	cpu->SP--;
 
 	// Cycle 2: push low byte of return address on stack, decrement SP
-	write(*cpu->bus, 0x0100 + cpu->SP, (cpu->PC + 1) & 0xFF);
+	write_stack(cpu->bus, cpu->SP, (cpu->PC + 1) & 0xFF);
 	cpu->SP--;
 	
 	// Cycle 3: fetch low byte of address, incement PC
-	byte adl = read(*cpu->bus, cpu->PC);
+	byte adl = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 4:  fetch high byte of address, increment PC
-	byte adh = read(*cpu->bus, cpu->PC);
+	byte adh = read(cpu->bus, cpu->PC);
 	word addr = adl + (adh << 8);
 	cpu->PC++;
 
@@ -3148,7 +3196,7 @@ struct opreturn do_ORA_imm(CPU *cpu)
 	// 	Do the OR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	int result = cpu->A | M;
@@ -3178,18 +3226,18 @@ struct opreturn do_ORA_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the OR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A | M;
 
@@ -3221,12 +3269,12 @@ struct opreturn do_ORA_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -3234,7 +3282,7 @@ struct opreturn do_ORA_absX(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -3244,7 +3292,7 @@ struct opreturn do_ORA_absX(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the OR operation
@@ -3281,12 +3329,12 @@ struct opreturn do_ORA_absY(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add Y to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -3294,7 +3342,7 @@ struct opreturn do_ORA_absY(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -3304,7 +3352,7 @@ struct opreturn do_ORA_absY(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the OR operation
@@ -3338,14 +3386,14 @@ struct opreturn do_ORA_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the OR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A | M;
 
@@ -3374,7 +3422,7 @@ struct opreturn do_ORA_zpgX(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
@@ -3384,7 +3432,7 @@ struct opreturn do_ORA_zpgX(CPU *cpu)
 	// 	Do the OR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A | M;
 
@@ -3413,25 +3461,25 @@ struct opreturn do_ORA_Xind(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5: fetch byte
 	// 	Do the OR operation
 	// 	Set N,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A | M;
 
@@ -3462,22 +3510,22 @@ struct opreturn do_ORA_indY(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, fetch byte and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -3487,7 +3535,7 @@ struct opreturn do_ORA_indY(CPU *cpu)
 
 		// Cycle 5:  fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 
 	// 	Do the OR operation
@@ -3519,7 +3567,7 @@ struct opreturn do_PHA_impl(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: copy A to stack
-	write(*cpu->bus, 0x0100 + cpu->SP, cpu->A);
+	write_stack(cpu->bus, cpu->SP, cpu->A);
 
 	// Cycle 2: Decrement stack pointer
 	cpu->SP--;
@@ -3543,7 +3591,7 @@ struct opreturn do_PHP_impl(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: copy SR to stack, setting B
-	write(*cpu->bus, 0x0100 + cpu->SP, cpu->SR | 0x10);
+	write_stack(cpu->bus, cpu->SP, get_SR(cpu) | 0x10);
 
 	// Cycle 2: Decrement stack pointer
 	cpu->SP--;
@@ -3570,7 +3618,7 @@ struct opreturn do_PLA_impl(CPU *cpu)
 	cpu->SP++;
 
 	// Cycle 2: copy byte from stack to A
-	cpu->A = read(*cpu->bus, 0x0100 + cpu->SP);
+	cpu->A = read_stack(cpu->bus, cpu->SP);
 
 	// Cycle 3: set N,Z if necessary
 	set_N(cpu, cpu->A);
@@ -3598,7 +3646,8 @@ struct opreturn do_PLP_impl(CPU *cpu)
 	cpu->SP++;
 
 	// Cycle 2: copy byte from stack to A
-	cpu->SR = read(*cpu->bus, 0x0100 + cpu->SP);
+	update_SR(cpu);
+	cpu->SR = read_stack(cpu->bus, cpu->SP);
 
 	// Cycle 3: Not sure what happens here.  Flags should be set
 
@@ -3622,7 +3671,7 @@ struct opreturn do_LDA_imm(CPU *cpu)
 
 	// Cycle 1: fetch byte and store in A, increment PC
 	// 	set N,Z if necessary
-	cpu->A = read(*cpu->bus, cpu->PC);
+	cpu->A = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	set_N(cpu, cpu->A);
@@ -3647,16 +3696,16 @@ struct opreturn do_LDA_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3:  store byte in A
 	// 	Set N,Z if necessary
-	cpu->A = read(*cpu->bus, addr);
+	cpu->A = read(cpu->bus, addr);
 
 	set_N(cpu, cpu->A);
 	set_Z(cpu, cpu->A);
@@ -3682,12 +3731,12 @@ struct opreturn do_LDA_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -3695,7 +3744,7 @@ struct opreturn do_LDA_absX(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		cpu->A = read(*cpu->bus, addr);
+		cpu->A = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and do load on next cycle
 	{
@@ -3705,7 +3754,7 @@ struct opreturn do_LDA_absX(CPU *cpu)
 
 		// Cycle 4:  store byte in A
 		addr = (bah << 8) + bal;
-		cpu->A = read(*cpu->bus, addr);
+		cpu->A = read(cpu->bus, addr);
 	}
 
 	// Set N,Z if necessary
@@ -3733,12 +3782,12 @@ struct opreturn do_LDA_absY(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add Y to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -3746,7 +3795,7 @@ struct opreturn do_LDA_absY(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		cpu->A = read(*cpu->bus, addr);
+		cpu->A = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and do load on next cycle
 	{
@@ -3756,7 +3805,7 @@ struct opreturn do_LDA_absY(CPU *cpu)
 
 		// Cycle 4:  store byte in A
 		addr = (bah << 8) + bal;
-		cpu->A = read(*cpu->bus, addr);
+		cpu->A = read(cpu->bus, addr);
 	}
 
 	// Set N,Z if necessary
@@ -3782,12 +3831,12 @@ struct opreturn do_LDA_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  store byte in A
 	// 	Set N,Z if necessary
-	cpu->A = read(*cpu->bus, addr);
+	cpu->A = read_zp(cpu->bus, addr);
 
 	set_N(cpu, cpu->A);
 	set_Z(cpu, cpu->A);
@@ -3811,7 +3860,7 @@ struct opreturn do_LDA_zpgX(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
@@ -3819,7 +3868,7 @@ struct opreturn do_LDA_zpgX(CPU *cpu)
 
 	// Cycle 3:  store byte in A
 	// 	Set N,Z if necessary
-	cpu->A = read(*cpu->bus, addr);
+	cpu->A = read_zp(cpu->bus, addr);
 
 	set_N(cpu, cpu->A);
 	set_Z(cpu, cpu->A);
@@ -3843,23 +3892,23 @@ struct opreturn do_LDA_Xind(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5:  store byte in A
 	// 	Set N,Z if necessary
-	cpu->A = read(*cpu->bus, addr);
+	cpu->A = read(cpu->bus, addr);
 
 	set_N(cpu, cpu->A);
 	set_Z(cpu, cpu->A);
@@ -3884,22 +3933,22 @@ struct opreturn do_LDA_indY(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, load A and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		cpu->A = read(*cpu->bus, addr);
+		cpu->A = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and do load on next cycle
 	{
@@ -3909,7 +3958,7 @@ struct opreturn do_LDA_indY(CPU *cpu)
 
 		// Cycle 4:  store byte in A
 		addr = (bah << 8) + bal;
-		cpu->A = read(*cpu->bus, addr);
+		cpu->A = read(cpu->bus, addr);
 	}
 
 	// Set N,Z if necessary
@@ -3936,7 +3985,7 @@ struct opreturn do_LDX_imm(CPU *cpu)
 
 	// Cycle 1: fetch byte and store in X, increment PC
 	// 	set N,Z if necessary
-	cpu->X = read(*cpu->bus, cpu->PC);
+	cpu->X = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	set_N(cpu, cpu->X);
@@ -3961,16 +4010,16 @@ struct opreturn do_LDX_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3:  store byte in X
 	// 	Set N,Z if necessary
-	cpu->X = read(*cpu->bus, addr);
+	cpu->X = read(cpu->bus, addr);
 
 	set_N(cpu, cpu->X);
 	set_Z(cpu, cpu->X);
@@ -3996,12 +4045,12 @@ struct opreturn do_LDX_absY(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add Y to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -4009,7 +4058,7 @@ struct opreturn do_LDX_absY(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		cpu->X = read(*cpu->bus, addr);
+		cpu->X = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and do load on next cycle
 	{
@@ -4019,7 +4068,7 @@ struct opreturn do_LDX_absY(CPU *cpu)
 
 		// Cycle 4:  store byte in X
 		addr = (bah << 8) + bal;
-		cpu->X = read(*cpu->bus, addr);
+		cpu->X = read(cpu->bus, addr);
 	}
 
 	// Set N,Z if necessary
@@ -4045,12 +4094,12 @@ struct opreturn do_LDX_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  store byte in X
 	// 	Set N,Z if necessary
-	cpu->X = read(*cpu->bus, addr);
+	cpu->X = read_zp(cpu->bus, addr);
 
 	set_N(cpu, cpu->X);
 	set_Z(cpu, cpu->X);
@@ -4074,7 +4123,7 @@ struct opreturn do_LDX_zpgY(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add Y to address
@@ -4082,7 +4131,7 @@ struct opreturn do_LDX_zpgY(CPU *cpu)
 
 	// Cycle 3:  store byte in X
 	// 	Set N,Z if necessary
-	cpu->X = read(*cpu->bus, addr);
+	cpu->X = read_zp(cpu->bus, addr);
 
 	set_N(cpu, cpu->X);
 	set_Z(cpu, cpu->X);
@@ -4107,7 +4156,7 @@ struct opreturn do_LDY_imm(CPU *cpu)
 
 	// Cycle 1: fetch byte and store in Y, increment PC
 	// 	set N,Z if necessary
-	cpu->Y = read(*cpu->bus, cpu->PC);
+	cpu->Y = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	set_N(cpu, cpu->Y);
@@ -4132,16 +4181,16 @@ struct opreturn do_LDY_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3:  store byte in Y
 	// 	Set N,Z if necessary
-	cpu->Y = read(*cpu->bus, addr);
+	cpu->Y = read(cpu->bus, addr);
 
 	set_N(cpu, cpu->Y);
 	set_Z(cpu, cpu->Y);
@@ -4167,12 +4216,12 @@ struct opreturn do_LDY_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -4180,7 +4229,7 @@ struct opreturn do_LDY_absX(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		cpu->Y = read(*cpu->bus, addr);
+		cpu->Y = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and do load on next cycle
 	{
@@ -4190,7 +4239,7 @@ struct opreturn do_LDY_absX(CPU *cpu)
 
 		// Cycle 4:  store byte in Y
 		addr = (bah << 8) + bal;
-		cpu->Y = read(*cpu->bus, addr);
+		cpu->Y = read(cpu->bus, addr);
 	}
 
 	// Set N,Z if necessary
@@ -4216,12 +4265,12 @@ struct opreturn do_LDY_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  store byte in Y
 	// 	Set N,Z if necessary
-	cpu->Y = read(*cpu->bus, addr);
+	cpu->Y = read_zp(cpu->bus, addr);
 
 	set_N(cpu, cpu->Y);
 	set_Z(cpu, cpu->Y);
@@ -4245,7 +4294,7 @@ struct opreturn do_LDY_zpgX(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
@@ -4253,7 +4302,7 @@ struct opreturn do_LDY_zpgX(CPU *cpu)
 
 	// Cycle 3:  store byte in Y
 	// 	Set N,Z if necessary
-	cpu->Y = read(*cpu->bus, addr);
+	cpu->Y = read_zp(cpu->bus, addr);
 
 	set_N(cpu, cpu->Y);
 	set_Z(cpu, cpu->Y);
@@ -4288,7 +4337,7 @@ struct opreturn do_LSR_A(CPU *cpu)
 	cpu->A >>= 1;
 
 	//   Clear N
-	cpu->SR &= ~N;
+	set_N(cpu, 0);
 	//   Set Z if necessary
 	set_Z(cpu, cpu->A);
 
@@ -4311,15 +4360,15 @@ struct opreturn do_LSR_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 4: Copy bit 0 to carry and shift right
 	if ((M & 0x1) == 0)
@@ -4333,12 +4382,12 @@ struct opreturn do_LSR_abs(CPU *cpu)
 	M >>= 1;
 
 	//   Clear N
-	cpu->SR &= ~N;
+	set_N(cpu, 0);
 	//   Set Z if necessary
 	set_Z(cpu, M);
 
 	// Cycle 5: Store back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4360,12 +4409,12 @@ struct opreturn do_LSR_absX(CPU *cpu)
 	
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -4378,7 +4427,7 @@ struct opreturn do_LSR_absX(CPU *cpu)
 
 	// Cycle 4: fetch byte
 	word addr = (bah << 8) + bal;
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 5: Copy bit 0 to carry and shift right
 	if ((M & 0x1) == 0)
@@ -4392,12 +4441,12 @@ struct opreturn do_LSR_absX(CPU *cpu)
 	M >>= 1;
 
 	//   Clear N
-	cpu->SR &= ~N;
+	set_N(cpu, 0);
 	//   Set Z if necessary
 	set_Z(cpu, M);
 
 	// Cycle 6: Store back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4418,11 +4467,11 @@ struct opreturn do_LSR_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 3: Copy bit 0 to carry and shift right
 	if ((M & 0x1) == 0)
@@ -4436,12 +4485,12 @@ struct opreturn do_LSR_zpg(CPU *cpu)
 	M >>= 1;
 
 	//   Clear N
-	cpu->SR &= ~N;
+	set_N(cpu, 0);
 	//   Set Z if necessary
 	set_Z(cpu, M);
 
 	// Cycle 4: Store back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4462,14 +4511,14 @@ struct opreturn do_LSR_zpgX(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 4: Copy bit 0 to carry and shift rigth
 	if ((M & 0x1) == 0)
@@ -4483,12 +4532,12 @@ struct opreturn do_LSR_zpgX(CPU *cpu)
 	M >>= 1;
 
 	//   Clear N
-	cpu->SR &= ~N;
+	set_N(cpu, 0);
 	//   Set Z if necessary
 	set_Z(cpu, M);
 
 	// Cycle 5: Store back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4565,15 +4614,15 @@ struct opreturn do_ROL_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 4: Save current carry state, copy bit 7 (N) to carry,
 	// 	shift left, and put carry in bit 0
@@ -4594,7 +4643,7 @@ struct opreturn do_ROL_abs(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4616,12 +4665,12 @@ struct opreturn do_ROL_absX(CPU *cpu)
 	
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -4634,7 +4683,7 @@ struct opreturn do_ROL_absX(CPU *cpu)
 
 	// Cycle 4: fetch byte
 	word addr = (bah << 8) + bal;
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 5: Save current carry state, copy bit 7 (N) to carry,
 	// 	shift left, and put carry in bit 0
@@ -4655,7 +4704,7 @@ struct opreturn do_ROL_absX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 6: Store back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4676,11 +4725,11 @@ struct opreturn do_ROL_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 3: Save current carry state, copy bit 7 (N) to carry,
 	// 	shift left, and put carry in bit 0
@@ -4701,7 +4750,7 @@ struct opreturn do_ROL_zpg(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 4: Store back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4722,14 +4771,14 @@ struct opreturn do_ROL_zpgX(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 4: Save current carry state, copy bit 7 (N) to carry,
 	// 	shift left, and put carry in bit 0
@@ -4750,7 +4799,7 @@ struct opreturn do_ROL_zpgX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4807,15 +4856,15 @@ struct opreturn do_ROR_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 4: Save current carry state, copy bit 0 to carry,
 	// 	shift right, and put carry in bit 7
@@ -4836,7 +4885,7 @@ struct opreturn do_ROR_abs(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4858,12 +4907,12 @@ struct opreturn do_ROR_absX(CPU *cpu)
 	
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -4876,7 +4925,7 @@ struct opreturn do_ROR_absX(CPU *cpu)
 
 	// Cycle 4: fetch byte
 	word addr = (bah << 8) + bal;
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	// Cycle 5: Save current carry state, copy bit 0 to carry,
 	// 	shift right, and put carry in bit 7
@@ -4897,7 +4946,7 @@ struct opreturn do_ROR_absX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 6: Store back in memory
-	write(*cpu->bus, addr, M);
+	write(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4918,11 +4967,11 @@ struct opreturn do_ROR_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 3: Save current carry state, copy bit 0 to carry,
 	// 	shift right, and put carry in bit 7
@@ -4943,7 +4992,7 @@ struct opreturn do_ROR_zpg(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 4: Store back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -4964,14 +5013,14 @@ struct opreturn do_ROR_zpgX(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	// Cycle 4: Save current carry state, copy bit 0 to carry,
 	// 	shift right, and put carry in bit 7
@@ -4992,7 +5041,7 @@ struct opreturn do_ROR_zpgX(CPU *cpu)
 	set_Z(cpu, M);
 
 	// Cycle 5: Store back in memory
-	write(*cpu->bus, addr, M);
+	write_zp(cpu->bus, addr, M);
 
 	opr.operand = addr;
 	opr.result = M;
@@ -5017,15 +5066,16 @@ struct opreturn do_RTI_impl(CPU *cpu)
 
 	// Cycle 3: increment stack pointer, pull status register
 	cpu->SP++;
-	cpu->SR = read(*cpu->bus, 0x100 + cpu->SP);
+	update_SR(cpu);
+	cpu->SR = read_stack(cpu->bus, cpu->SP);
 
 	// Cycle 4: increment stack pointer, pull low byte of return address
 	cpu->SP++;
-	byte adl = read(*cpu->bus, 0x100 + cpu->SP);
+	byte adl = read_stack(cpu->bus, cpu->SP);
 
 	// Cycle 5: pull high byte of return address from stack
 	cpu->SP++;
-	byte adh = read(*cpu->bus, 0x100 + cpu->SP);
+	byte adh = read_stack(cpu->bus, cpu->SP);
 
 	//   Put return address into PC
 	cpu->PC = adl + (adh << 8);
@@ -5052,13 +5102,13 @@ struct opreturn do_RTS_impl(CPU *cpu)
 	cpu->SP++;
 
 	// Cycle 2: pull low byte of return address from stack
-	byte adl = read(*cpu->bus, 0x100 + cpu->SP);
+	byte adl = read_stack(cpu->bus, cpu->SP);
 
 	// Cycle 3:  Increment stack pointer
 	cpu->SP++;
 
 	// Cycle 4: pull high byte of return address from stack
-	byte adh = read(*cpu->bus, 0x100 + cpu->SP);
+	byte adh = read_stack(cpu->bus, cpu->SP);
 
 	// Cycle 5: Put return address into PC (add 1 for next instruction)
 	cpu->PC = adl + (adh << 8) + 1;
@@ -5086,7 +5136,7 @@ struct opreturn do_SBC_imm(CPU *cpu)
 	// 	Do the subtraction and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	int result = cpu->A + (~M&0xFF) + ((cpu->SR & C)?1:0);
@@ -5119,18 +5169,18 @@ struct opreturn do_SBC_abs(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A + (~M&0xFF) + ((cpu->SR & C)?1:0);
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -5165,12 +5215,12 @@ struct opreturn do_SBC_absX(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -5178,7 +5228,7 @@ struct opreturn do_SBC_absX(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -5188,7 +5238,7 @@ struct opreturn do_SBC_absX(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the subtraction and update C
@@ -5227,12 +5277,12 @@ struct opreturn do_SBC_absY(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -5240,7 +5290,7 @@ struct opreturn do_SBC_absY(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -5250,7 +5300,7 @@ struct opreturn do_SBC_absY(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
 	// 	Do the subtraction and update C
@@ -5286,14 +5336,14 @@ struct opreturn do_SBC_zpg(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A + (~M&0xFF) + ((cpu->SR & C)?1:0);
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -5325,7 +5375,7 @@ struct opreturn do_SBC_zpgX(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
@@ -5335,7 +5385,7 @@ struct opreturn do_SBC_zpgX(CPU *cpu)
 	// 	Do the subtraction and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read_zp(cpu->bus, addr);
 
 	int result = cpu->A + (~M&0xFF) + ((cpu->SR & C)?1:0);
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -5367,25 +5417,25 @@ struct opreturn do_SBC_Xind(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5: fetch byte
 	// 	Do the subtraction and update C
 	// 	Set N,V,Z if necessary
 	// 	Store in A
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
 	int result = cpu->A + (~M&0xFF) + ((cpu->SR & C)?1:0);
 	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
@@ -5419,22 +5469,22 @@ struct opreturn do_SBC_indY(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, fetch byte and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and do fetch on next cycle
 	{
@@ -5444,7 +5494,7 @@ struct opreturn do_SBC_indY(CPU *cpu)
 
 		// Cycle 4:  fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 
 	// 	Do the subtraction and update C
@@ -5483,7 +5533,7 @@ struct opreturn do_SEC_impl(CPU *cpu)
 	cpu->SR |= C;
 
 	opr.operand = 0;
-	opr.result = cpu->SR;
+	opr.result = get_SR(cpu);
 
 	return opr;
 }
@@ -5504,12 +5554,31 @@ struct opreturn do_SEI_impl(CPU *cpu)
 	cpu->SR |= I;
 
 	opr.operand = 0;
-	opr.result = cpu->SR;
+	opr.result = get_SR(cpu);
 
 	return opr;
 }
 
-// SED is below the execute array assignment
+struct opreturn do_SED_impl(CPU *cpu)
+// Set Decimal flag
+{
+	struct opreturn opr;
+
+	opr.bytes = 1;
+	opr.cycles = 2;
+	opr.mnemonic = "SED   ";
+
+	// Cycle 0: instruction fetched, increment PC
+	cpu->PC++;
+
+	// Cycle 1: Set D
+	cpu->SR |= D;
+
+	opr.operand = 0;
+	opr.result = get_SR(cpu);
+
+	return opr;
+}
 
 struct opreturn do_STA_abs(CPU *cpu)
 // Store Accumulator in memory with absolute addressing
@@ -5524,15 +5593,15 @@ struct opreturn do_STA_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3:  store A at addr
-	write(*cpu->bus, addr, cpu->A);
+	write(cpu->bus, addr, cpu->A);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5554,12 +5623,12 @@ struct opreturn do_STA_absX(CPU *cpu)
 	
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -5572,7 +5641,7 @@ struct opreturn do_STA_absX(CPU *cpu)
 
 	// Cycle 4:  store A at addr
 	word addr = (bah << 8) + bal;
-	write(*cpu->bus, addr, cpu->A);
+	write(cpu->bus, addr, cpu->A);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5594,12 +5663,12 @@ struct opreturn do_STA_absY(CPU *cpu)
 	
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add Y to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -5612,7 +5681,7 @@ struct opreturn do_STA_absY(CPU *cpu)
 
 	// Cycle 4:  store A at addr
 	word addr = (bah << 8) + bal;
-	write(*cpu->bus, addr, cpu->A);
+	write(cpu->bus, addr, cpu->A);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5633,11 +5702,11 @@ struct opreturn do_STA_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  store A at addr
-	write(*cpu->bus, addr, cpu->A);
+	write_zp(cpu->bus, addr, cpu->A);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5658,14 +5727,14 @@ struct opreturn do_STA_zpgX(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3:  store A at addr
-	write(*cpu->bus, addr, cpu->A);
+	write_zp(cpu->bus, addr, cpu->A);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5686,22 +5755,22 @@ struct opreturn do_STA_Xind(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5:  store A at addr
-	write(*cpu->bus, addr, cpu->A);
+	write(cpu->bus, addr, cpu->A);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5722,15 +5791,15 @@ struct opreturn do_STA_indY(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4: add carry to high byte of address if necessary
@@ -5742,7 +5811,7 @@ struct opreturn do_STA_indY(CPU *cpu)
 
 	// Cycle 5:  store A at addr
 	word addr = (bah << 8) + bal;
-	write(*cpu->bus, addr, cpu->A);
+	write(cpu->bus, addr, cpu->A);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5763,15 +5832,15 @@ struct opreturn do_STX_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3:  store X at addr
-	write(*cpu->bus, addr, cpu->X);
+	write(cpu->bus, addr, cpu->X);
 
 	opr.operand = addr;
 	opr.result = cpu->X;
@@ -5792,11 +5861,11 @@ struct opreturn do_STX_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  store X at addr
-	write(*cpu->bus, addr, cpu->X);
+	write_zp(cpu->bus, addr, cpu->X);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5817,14 +5886,14 @@ struct opreturn do_STX_zpgY(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add Y to address
 	addr = addr + cpu->Y;
 
 	// Cycle 3:  store X at addr
-	write(*cpu->bus, addr, cpu->X);
+	write_zp(cpu->bus, addr, cpu->X);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5845,15 +5914,15 @@ struct opreturn do_STY_abs(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3:  store Y at addr
-	write(*cpu->bus, addr, cpu->Y);
+	write(cpu->bus, addr, cpu->Y);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5874,11 +5943,11 @@ struct opreturn do_STY_zpg(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  store Y at addr
-	write(*cpu->bus, addr, cpu->Y);
+	write_zp(cpu->bus, addr, cpu->Y);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -5899,14 +5968,14 @@ struct opreturn do_STY_zpgX(CPU *cpu)
 	cpu->PC++;
 	
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3:  store Y at addr
-	write(*cpu->bus, addr, cpu->Y);
+	write_zp(cpu->bus, addr, cpu->Y);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6059,7 +6128,7 @@ struct opreturn do_TYA_impl(CPU *cpu)
 struct opreturn do_ADC_imm_BCD(CPU *cpu)
 // Add with Carry, immediate addressing - BCD mode
 // 	A, C = A + M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
@@ -6071,56 +6140,11 @@ struct opreturn do_ADC_imm_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
-	//		Store values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// 	Do the addition
-	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
-	if (AL >= 0x0A)
-	{
-		AL = ((AL + 0x06) & 0x0F) + 0x10;
-	}
-	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
-
-	// Set N
-	set_N(cpu, new_A);
-	
-	// Set V (doesn't work correctly)
-	if ((new_A < -128) || (new_A > 127))
-	{
-		cpu->SR |= V;
-	}
-	else
-	{
-		cpu->SR &= ~V;
-	}
-	// then continue
-
-	if (new_A >= 0xA0)
-	{
-		new_A = new_A + 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// Set the carry bit
-	if (new_A >= 0x100)
-	{
-		cpu->SR |= C;
-	}
-	else
-	{
-		cpu->SR &= ~C;
-	}
-
-	// 	Redo the math in true binary and set Z
-	new_A = old_A + M + old_C;
-	set_Z(cpu, new_A);
+	// 	Look up the sum, with N, V, Z and C
+	adc_bcd(cpu, M);
 
 	opr.operand = M;
 	opr.result = cpu->A;
@@ -6131,7 +6155,7 @@ struct opreturn do_ADC_imm_BCD(CPU *cpu)
 struct opreturn do_ADC_abs_BCD(CPU *cpu)
 // Add with Carry, absolute addressing - BCD mode
 // 	A, C = A + M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
@@ -6143,63 +6167,18 @@ struct opreturn do_ADC_abs_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3:  fetch byte
-	byte M = read(*cpu->bus, addr);
-
-	//		Store values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// 	Do the addition
-	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
-	if (AL >= 0x0A)
-	{
-		AL = ((AL + 0x06) & 0x0F) + 0x10;
-	}
-	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
-
-	// Set N
-	set_N(cpu, new_A);
-	
-	// Set V (doesn't work correctly)
-	if ((new_A < -128) || (new_A > 127))
-	{
-		cpu->SR |= V;
-	}
-	else
-	{
-		cpu->SR &= ~V;
-	}
-	// then continue
+	byte M = read(cpu->bus, addr);
 
-	if (new_A >= 0xA0)
-	{
-		new_A = new_A + 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// Set the carry bit
-	if (new_A >= 0x100)
-	{
-		cpu->SR |= C;
-	}
-	else
-	{
-		cpu->SR &= ~C;
-	}
-
-	// 	Redo the math in true binary and set Z
-	new_A = old_A + M + old_C;
-	set_Z(cpu, new_A);
+	// 	Look up the sum, with N, V, Z and C
+	adc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6210,7 +6189,7 @@ struct opreturn do_ADC_abs_BCD(CPU *cpu)
 struct opreturn do_ADC_absX_BCD(CPU *cpu)
 // Add with Carry, x-indexed absolute addressing - BCD mode
 // 	A, C = A + M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	word addr;			// Memory location
 	byte M;				// Addend from memory
@@ -6225,12 +6204,12 @@ struct opreturn do_ADC_absX_BCD(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -6238,7 +6217,7 @@ struct opreturn do_ADC_absX_BCD(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -6248,56 +6227,11 @@ struct opreturn do_ADC_absX_BCD(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
-	}
-	
-	//		Store values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// 	Do the addition
-	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
-	if (AL >= 0x0A)
-	{
-		AL = ((AL + 0x06) & 0x0F) + 0x10;
+		M = read(cpu->bus, addr);
 	}
-	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
-
-	// Set N
-	set_N(cpu, new_A);
 	
-	// Set V (doesn't work correctly)
-	if ((new_A < -128) || (new_A > 127))
-	{
-		cpu->SR |= V;
-	}
-	else
-	{
-		cpu->SR &= ~V;
-	}
-	// then continue
-
-	if (new_A >= 0xA0)
-	{
-		new_A = new_A + 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// Set the carry bit
-	if (new_A >= 0x100)
-	{
-		cpu->SR |= C;
-	}
-	else
-	{
-		cpu->SR &= ~C;
-	}
-
-	// 	Redo the math in true binary and set Z
-	new_A = old_A + M + old_C;
-	set_Z(cpu, new_A);
+	// 	Look up the sum, with N, V, Z and C
+	adc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6308,7 +6242,7 @@ struct opreturn do_ADC_absX_BCD(CPU *cpu)
 struct opreturn do_ADC_absY_BCD(CPU *cpu)
 // Add with Carry, y-indexed absolute addressing - BCD mode
 // 	A, C = A + M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	word addr;			// Memory location
 	byte M;				// Addend from memory
@@ -6323,12 +6257,12 @@ struct opreturn do_ADC_absY_BCD(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -6336,7 +6270,7 @@ struct opreturn do_ADC_absY_BCD(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -6346,56 +6280,11 @@ struct opreturn do_ADC_absY_BCD(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
-	}
-	
-	//		Store values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// 	Do the addition
-	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
-	if (AL >= 0x0A)
-	{
-		AL = ((AL + 0x06) & 0x0F) + 0x10;
+		M = read(cpu->bus, addr);
 	}
-	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
-
-	// Set N
-	set_N(cpu, new_A);
 	
-	// Set V (doesn't work correctly)
-	if ((new_A < -128) || (new_A > 127))
-	{
-		cpu->SR |= V;
-	}
-	else
-	{
-		cpu->SR &= ~V;
-	}
-	// then continue
-
-	if (new_A >= 0xA0)
-	{
-		new_A = new_A + 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// Set the carry bit
-	if (new_A >= 0x100)
-	{
-		cpu->SR |= C;
-	}
-	else
-	{
-		cpu->SR &= ~C;
-	}
-
-	// 	Redo the math in true binary and set Z
-	new_A = old_A + M + old_C;
-	set_Z(cpu, new_A);
+	// 	Look up the sum, with N, V, Z and C
+	adc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6406,7 +6295,7 @@ struct opreturn do_ADC_absY_BCD(CPU *cpu)
 struct opreturn do_ADC_zpg_BCD(CPU *cpu)
 // Add with Carry, zero page addressing - BCD mode
 // 	A, C = A + M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
@@ -6418,59 +6307,14 @@ struct opreturn do_ADC_zpg_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch byte
-	byte M = read(*cpu->bus, addr);
-
-	//		Store values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// 	Do the addition
-	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
-	if (AL >= 0x0A)
-	{
-		AL = ((AL + 0x06) & 0x0F) + 0x10;
-	}
-	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
-
-	// Set N
-	set_N(cpu, new_A);
-	
-	// Set V (doesn't work correctly)
-	if ((new_A < -128) || (new_A > 127))
-	{
-		cpu->SR |= V;
-	}
-	else
-	{
-		cpu->SR &= ~V;
-	}
-	// then continue
-
-	if (new_A >= 0xA0)
-	{
-		new_A = new_A + 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// Set the carry bit
-	if (new_A >= 0x100)
-	{
-		cpu->SR |= C;
-	}
-	else
-	{
-		cpu->SR &= ~C;
-	}
+	byte M = read_zp(cpu->bus, addr);
 
-	// 	Redo the math in true binary and set Z
-	new_A = old_A + M + old_C;
-	set_Z(cpu, new_A);
+	// 	Look up the sum, with N, V, Z and C
+	adc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6481,7 +6325,7 @@ struct opreturn do_ADC_zpg_BCD(CPU *cpu)
 struct opreturn do_ADC_zpgX_BCD(CPU *cpu)
 // Add with Carry, X indexed zero page addressing - BCD mode
 // 	A, C = A + M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
@@ -6493,62 +6337,17 @@ struct opreturn do_ADC_zpgX_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3:  fetch byte
-	byte M = read(*cpu->bus, addr);
-
-	//		Store values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// 	Do the addition
-	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
-	if (AL >= 0x0A)
-	{
-		AL = ((AL + 0x06) & 0x0F) + 0x10;
-	}
-	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
-
-	// Set N
-	set_N(cpu, new_A);
-	
-	// Set V (doesn't work correctly)
-	if ((new_A < -128) || (new_A > 127))
-	{
-		cpu->SR |= V;
-	}
-	else
-	{
-		cpu->SR &= ~V;
-	}
-	// then continue
-
-	if (new_A >= 0xA0)
-	{
-		new_A = new_A + 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// Set the carry bit
-	if (new_A >= 0x100)
-	{
-		cpu->SR |= C;
-	}
-	else
-	{
-		cpu->SR &= ~C;
-	}
+	byte M = read_zp(cpu->bus, addr);
 
-	// 	Redo the math in true binary and set Z
-	new_A = old_A + M + old_C;
-	set_Z(cpu, new_A);
+	// 	Look up the sum, with N, V, Z and C
+	adc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6559,82 +6358,37 @@ struct opreturn do_ADC_zpgX_BCD(CPU *cpu)
 struct opreturn do_ADC_Xind_BCD(CPU *cpu)
 // Add with Carry, X indexed zero page indirect addressing - BCD mode
 // 	A, C = A + M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
 	opr.bytes = 2;
-	opr.cycles = 4;
+	opr.cycles = 6;
 	opr.mnemonic = "ADC X,ind";
 
 	// Cycle 0: instruction fetched, increment PC
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5:  fetch byte
-	byte M = read(*cpu->bus, addr);
-
-	//		Store values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// 	Do the addition
-	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
-	if (AL >= 0x0A)
-	{
-		AL = ((AL + 0x06) & 0x0F) + 0x10;
-	}
-	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
-
-	// Set N
-	set_N(cpu, new_A);
-	
-	// Set V (doesn't work correctly)
-	if ((new_A < -128) || (new_A > 127))
-	{
-		cpu->SR |= V;
-	}
-	else
-	{
-		cpu->SR &= ~V;
-	}
-	// then continue
-
-	if (new_A >= 0xA0)
-	{
-		new_A = new_A + 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// Set the carry bit
-	if (new_A >= 0x100)
-	{
-		cpu->SR |= C;
-	}
-	else
-	{
-		cpu->SR &= ~C;
-	}
+	byte M = read(cpu->bus, addr);
 
-	// 	Redo the math in true binary and set Z
-	new_A = old_A + M + old_C;
-	set_Z(cpu, new_A);
+	// 	Look up the sum, with N, V, Z and C
+	adc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6645,7 +6399,7 @@ struct opreturn do_ADC_Xind_BCD(CPU *cpu)
 struct opreturn do_ADC_indY_BCD(CPU *cpu)
 // Add with Carry, zero page indirect Y indexed addressing - BCD mode
 // 	A, C = A + M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	word addr;			// Memory location
 	byte M;				// Addend from memory
@@ -6659,22 +6413,22 @@ struct opreturn do_ADC_indY_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, fetch byte and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and do fetch on next cycle
 	{
@@ -6684,67 +6438,22 @@ struct opreturn do_ADC_indY_BCD(CPU *cpu)
 
 		// Cycle 4:  fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 
-	//		Store values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
+	// 	Look up the sum, with N, V, Z and C
+	adc_bcd(cpu, M);
 
-	// 	Do the addition
-	int AL = (old_A & 0x0F) + (M & 0x0F) + old_C;
-	if (AL >= 0x0A)
-	{
-		AL = ((AL + 0x06) & 0x0F) + 0x10;
-	}
-	int new_A = (old_A & 0xF0) + (M & 0xF0) + AL;
+	opr.operand = addr;
+	opr.result = cpu->A;
 
-	// Set N
-	set_N(cpu, new_A);
-	
-	// Set V (doesn't work correctly)
-	if ((new_A < -128) || (new_A > 127))
-	{
-		cpu->SR |= V;
-	}
-	else
-	{
-		cpu->SR &= ~V;
-	}
-	// then continue
-
-	if (new_A >= 0xA0)
-	{
-		new_A = new_A + 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// Set the carry bit
-	if (new_A >= 0x100)
-	{
-		cpu->SR |= C;
-	}
-	else
-	{
-		cpu->SR &= ~C;
-	}
-
-	// 	Redo the math in true binary and set Z
-	new_A = old_A + M + old_C;
-	set_Z(cpu, new_A);
-
-	opr.operand = addr;
-	opr.result = cpu->A;
-
-	return opr;
-}
+	return opr;
+}
 
 struct opreturn do_SBC_imm_BCD(CPU *cpu)
 // Subtract with Carry, immediate addressing - BCD mode
 // 	A, C = A + ~M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
@@ -6756,36 +6465,11 @@ struct opreturn do_SBC_imm_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch byte and increment PC
-	byte M = read(*cpu->bus, cpu->PC);
+	byte M = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
-	// 	Store old values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// Do the subtraction:
-	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
-	if (AL < 0)
-	{
-		AL = ((AL - 0x06) & 0x0F) - 0x10;
-	}
-	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
-	if (new_A < 0)
-	{
-		new_A = new_A - 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// 	Redo the math in true binary and set C,N,V,Z
-	//			The V flag isn't right.
-	int result = old_A + (~M&0xFF) + old_C;
-	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
-	set_C(cpu, result);
-	set_N(cpu, result);
-	set_V(cpu, old_A, ~M, result);
-	set_Z(cpu, result);
+	// 	Look up the difference, with N, V, Z and C
+	sbc_bcd(cpu, M);
 
 	opr.operand = M;
 	opr.result = cpu->A;
@@ -6796,7 +6480,7 @@ struct opreturn do_SBC_imm_BCD(CPU *cpu)
 struct opreturn do_SBC_abs_BCD(CPU *cpu)
 // Subtract with Carry, absolute addressing - BCD mode
 // 	A, C = A + ~M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
@@ -6808,43 +6492,18 @@ struct opreturn do_SBC_abs_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch low byte of address, incement PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of address, increment PC
-	addr = addr + (read(*cpu->bus, cpu->PC) << 8);
+	addr = addr + (read(cpu->bus, cpu->PC) << 8);
 	cpu->PC++;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
+	byte M = read(cpu->bus, addr);
 
-	// 	Store old values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// Do the subtraction:
-	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
-	if (AL < 0)
-	{
-		AL = ((AL - 0x06) & 0x0F) - 0x10;
-	}
-	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
-	if (new_A < 0)
-	{
-		new_A = new_A - 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// 	Redo the math in true binary and set C,N,V,Z
-	//			The V flag isn't right.
-	int result = old_A + (~M&0xFF) + old_C;
-	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
-	set_C(cpu, result);
-	set_N(cpu, result);
-	set_V(cpu, old_A, ~M, result);
-	set_Z(cpu, result);
+	// 	Look up the difference, with N, V, Z and C
+	sbc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6855,7 +6514,7 @@ struct opreturn do_SBC_abs_BCD(CPU *cpu)
 struct opreturn do_SBC_absX_BCD(CPU *cpu)
 // Subtract with Carry, x-indexed absolute addressing - BCD mode
 // 	A, C = A + ~M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	word addr;			// Memory location
 	byte M;				// Subtrahend from memory
@@ -6870,12 +6529,12 @@ struct opreturn do_SBC_absX_BCD(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->X;
 	cpu->PC++;
 
@@ -6883,7 +6542,7 @@ struct opreturn do_SBC_absX_BCD(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -6893,36 +6552,11 @@ struct opreturn do_SBC_absX_BCD(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
-	// 	Store old values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// Do the subtraction:
-	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
-	if (AL < 0)
-	{
-		AL = ((AL - 0x06) & 0x0F) - 0x10;
-	}
-	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
-	if (new_A < 0)
-	{
-		new_A = new_A - 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// 	Redo the math in true binary and set C,N,V,Z
-	//			The V flag isn't right.
-	int result = old_A + (~M&0xFF) + old_C;
-	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
-	set_C(cpu, result);
-	set_N(cpu, result);
-	set_V(cpu, old_A, ~M, result);
-	set_Z(cpu, result);
+	// 	Look up the difference, with N, V, Z and C
+	sbc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -6933,7 +6567,7 @@ struct opreturn do_SBC_absX_BCD(CPU *cpu)
 struct opreturn do_SBC_absY_BCD(CPU *cpu)
 // Subtract with Carry, y-indexed absolute addressing - BCD mode
 // 	A, C = A + ~M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	word addr;			// Memory location
 	byte M;				// Subtrahend from memory
@@ -6948,12 +6582,12 @@ struct opreturn do_SBC_absY_BCD(CPU *cpu)
 
 	// Cycle 1: fetch low byte of base address, incement PC
 	// 	use two bytes for bal so we can catch the carry
-	word bal = read(*cpu->bus, cpu->PC);
+	word bal = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2:  fetch high byte of base address, add X to low byte
 	// 	increment PC
-	byte bah = read(*cpu->bus, cpu->PC);
+	byte bah = read(cpu->bus, cpu->PC);
 	bal = bal + cpu->Y;
 	cpu->PC++;
 
@@ -6961,7 +6595,7 @@ struct opreturn do_SBC_absY_BCD(CPU *cpu)
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and fetch byte on next cycle
 	{
@@ -6971,36 +6605,11 @@ struct opreturn do_SBC_absY_BCD(CPU *cpu)
 
 		// Cycle 4: fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
-	// 	Store old values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// Do the subtraction:
-	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
-	if (AL < 0)
-	{
-		AL = ((AL - 0x06) & 0x0F) - 0x10;
-	}
-	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
-	if (new_A < 0)
-	{
-		new_A = new_A - 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// 	Redo the math in true binary and set C,N,V,Z
-	//			The V flag isn't right.
-	int result = old_A + (~M&0xFF) + old_C;
-	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
-	set_C(cpu, result);
-	set_N(cpu, result);
-	set_V(cpu, old_A, ~M, result);
-	set_Z(cpu, result);
+	// 	Look up the difference, with N, V, Z and C
+	sbc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -7011,7 +6620,7 @@ struct opreturn do_SBC_absY_BCD(CPU *cpu)
 struct opreturn do_SBC_zpg_BCD(CPU *cpu)
 // Subtract with Carry, zero page addressing - BCD mode
 // 	A, C = A + ~M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
@@ -7023,39 +6632,14 @@ struct opreturn do_SBC_zpg_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address and increment PC
-	word addr = read(*cpu->bus, cpu->PC);
+	word addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch byte
-	byte M = read(*cpu->bus, addr);
-
-	// 	Store old values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// Do the subtraction:
-	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
-	if (AL < 0)
-	{
-		AL = ((AL - 0x06) & 0x0F) - 0x10;
-	}
-	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
-	if (new_A < 0)
-	{
-		new_A = new_A - 0x60;
-	}
+	byte M = read_zp(cpu->bus, addr);
 
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// 	Redo the math in true binary and set C,N,V,Z
-	//			The V flag isn't right.
-	int result = old_A + (~M&0xFF) + old_C;
-	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
-	set_C(cpu, result);
-	set_N(cpu, result);
-	set_V(cpu, old_A, ~M, result);
-	set_Z(cpu, result);
+	// 	Look up the difference, with N, V, Z and C
+	sbc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -7066,54 +6650,29 @@ struct opreturn do_SBC_zpg_BCD(CPU *cpu)
 struct opreturn do_SBC_zpgX_BCD(CPU *cpu)
 // Subtract with Carry, X indexed zero page addressing - BCD mode
 // 	A, C = A + ~M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
-	opr.bytes = 3;
+	opr.bytes = 2;
 	opr.cycles = 4;
-	opr.mnemonic = "SBC xpgX";
+	opr.mnemonic = "SBC zpg,X";
 
 	// Cycle 0: instruction fetched, increment PC
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte addr = read(*cpu->bus, cpu->PC);
+	byte addr = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to address
 	addr = addr + cpu->X;
 
 	// Cycle 3: fetch byte
-	byte M = read(*cpu->bus, addr);
-
-	// 	Store old values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
+	byte M = read_zp(cpu->bus, addr);
 
-	// Do the subtraction:
-	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
-	if (AL < 0)
-	{
-		AL = ((AL - 0x06) & 0x0F) - 0x10;
-	}
-	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
-	if (new_A < 0)
-	{
-		new_A = new_A - 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// 	Redo the math in true binary and set C,N,V,Z
-	//			The V flag isn't right.
-	int result = old_A + (~M&0xFF) + old_C;
-	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
-	set_C(cpu, result);
-	set_N(cpu, result);
-	set_V(cpu, old_A, ~M, result);
-	set_Z(cpu, result);
+	// 	Look up the difference, with N, V, Z and C
+	sbc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -7124,7 +6683,7 @@ struct opreturn do_SBC_zpgX_BCD(CPU *cpu)
 struct opreturn do_SBC_Xind_BCD(CPU *cpu)
 // Subtract with Carry, X indexed zero page indirect addressing - BCD mode
 // 	A, C = A + ~M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	struct opreturn opr;
 
@@ -7136,50 +6695,25 @@ struct opreturn do_SBC_Xind_BCD(CPU *cpu)
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: Add X to zpg address
 	zad = zad + cpu->X;
 
 	// Cycle 3: Fetch low byte of address, increment zpg address 
-	byte adl = read(*cpu->bus, zad);
+	byte adl = read_zp(cpu->bus, zad);
 	zad = zad + 1;
 
 	// Cycle 4: Fetch high byte of address
-	byte adh = read(*cpu->bus, zad);
+	byte adh = read_zp(cpu->bus, zad);
 	word addr = (adh << 8) + adl;
 
 	// Cycle 5: fetch byte
-	byte M = read(*cpu->bus, addr);
-
-	// 	Store old values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
+	byte M = read(cpu->bus, addr);
 
-	// Do the subtraction:
-	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
-	if (AL < 0)
-	{
-		AL = ((AL - 0x06) & 0x0F) - 0x10;
-	}
-	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
-	if (new_A < 0)
-	{
-		new_A = new_A - 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// 	Redo the math in true binary and set C,N,V,Z
-	//			The V flag isn't right.
-	int result = old_A + (~M&0xFF) + old_C;
-	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
-	set_C(cpu, result);
-	set_N(cpu, result);
-	set_V(cpu, old_A, ~M, result);
-	set_Z(cpu, result);
+	// 	Look up the difference, with N, V, Z and C
+	sbc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -7190,36 +6724,36 @@ struct opreturn do_SBC_Xind_BCD(CPU *cpu)
 struct opreturn do_SBC_indY_BCD(CPU *cpu)
 // Subtract with Carry, zero page indirect Y indexed addressing - BCD mode
 // 	A, C = A + ~M + C
-// 	Algorithm from http://www.6502.org/tutorials/decimal_mode.html#A
+// 	Result and flags come from the tables in bcd.c
 {
 	word addr;			// Memory location
 	byte M;				// Subtrahend from memory
 	struct opreturn opr;
 
 	opr.bytes = 2;
-	opr.cycles = 4;
+	opr.cycles = 5;
 	opr.mnemonic = "SBC ind,Y";
 
 	// Cycle 0: instruction fetched, increment PC
 	cpu->PC++;
 
 	// Cycle 1: fetch zpg address, incement PC
-	byte zad = read(*cpu->bus, cpu->PC);
+	byte zad = read(cpu->bus, cpu->PC);
 	cpu->PC++;
 
 	// Cycle 2: fetch low byte of base address
-	word bal = read(*cpu->bus, zad);
+	word bal = read_zp(cpu->bus, zad);
 
 	// Cycle 3: fetch high byte of base address, add Y to low byte
 	zad = zad + 1;
-	byte bah = read(*cpu->bus, zad);
+	byte bah = read_zp(cpu->bus, zad);
 	bal = bal + cpu->Y;
 
 	// Cycle 4:  if no carry on bal, fetch byte and be done 
 	if (bal < 256)
 	{
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}	
 	else //	otherwise, add carry to bah and do fetch on next cycle
 	{
@@ -7229,36 +6763,11 @@ struct opreturn do_SBC_indY_BCD(CPU *cpu)
 
 		// Cycle 4:  fetch byte
 		addr = (bah << 8) + bal;
-		M = read(*cpu->bus, addr);
+		M = read(cpu->bus, addr);
 	}
 	
-	// 	Store old values for flag checks at end
-	byte old_A = cpu->A;
-	byte old_C = (cpu->SR & C)?1:0;
-
-	// Do the subtraction:
-	int AL = (old_A & 0x0F) - (M & 0x0F) + (old_C - 1);
-	if (AL < 0)
-	{
-		AL = ((AL - 0x06) & 0x0F) - 0x10;
-	}
-	int new_A = (old_A & 0xF0) - (M & 0xF0) + AL;
-	if (new_A < 0)
-	{
-		new_A = new_A - 0x60;
-	}
-
-	// 	Store in A
-	cpu->A = new_A & 0xFF;
-
-	// 	Redo the math in true binary and set C,N,V,Z
-	//			The V flag isn't right.
-	int result = old_A + (~M&0xFF) + old_C;
-	//	(Trim ~M to 8 bits so the carry bit doesn't get lost 24 bits to the left)
-	set_C(cpu, result);
-	set_N(cpu, result);
-	set_V(cpu, old_A, ~M, result);
-	set_Z(cpu, result);
+	// 	Look up the difference, with N, V, Z and C
+	sbc_bcd(cpu, M);
 
 	opr.operand = addr;
 	opr.result = cpu->A;
@@ -7266,7 +6775,10 @@ struct opreturn do_SBC_indY_BCD(CPU *cpu)
 	return opr;
 }
 
-struct opreturn (*execute[])(CPU *cpu) =
+// Instruction tables, selected by the D flag when the instruction is
+// 	dispatched.  They are never modified, so any number of CPUs can share
+// 	them.
+const ophandler execute_binary[256] =
 {
 do_BRK_impl, 	// 0x00
 do_ORA_Xind, 	// 0x01
@@ -7526,79 +7038,285 @@ do_INC_absX, 	// 0xFE
 do_NOP_impl  	// 0xFF
 };
 
-struct opreturn do_CLD_impl(CPU *cpu)
-// Clear Decimal flag
-{
-	struct opreturn opr;
-
-	opr.bytes = 1;
-	opr.cycles = 2;
-	opr.mnemonic = "CLD   ";
-
-	// Cycle 0: instruction fetched, increment PC
-	cpu->PC++;
-
-	// Cycle 1: Clear D
-	cpu->SR &= ~D;
-
-	// Swap arithmetic handlers
-	execute[0x69] = do_ADC_imm;
-	execute[0x6D] = do_ADC_abs;
-	execute[0x7D] = do_ADC_absX;
-	execute[0x79] = do_ADC_absY;
-	execute[0x65] = do_ADC_zpg;
-	execute[0x75] = do_ADC_zpgX;
-	execute[0x71] = do_ADC_indY;
-	execute[0xE9] = do_SBC_imm;
-	execute[0xED] = do_SBC_abs;
-	execute[0xFD] = do_SBC_absX;
-	execute[0xF9] = do_SBC_absY;
-	execute[0xE5] = do_SBC_zpg;
-	execute[0xF5] = do_SBC_zpgX;
-	execute[0xE1] = do_SBC_Xind;
-	execute[0xF1] = do_SBC_indY;
-
-	opr.operand = 0;
-	opr.result = cpu->SR;
-
-	return opr;
-}
-
-struct opreturn do_SED_impl(CPU *cpu)
-// Set Decimal flag
+// Same as above, with the BCD versions of ADC and SBC
+const ophandler execute_decimal[256] =
 {
-	struct opreturn opr;
-
-	opr.bytes = 1;
-	opr.cycles = 2;
-	opr.mnemonic = "SED   ";
-
-	// Cycle 0: instruction fetched, increment PC
-	cpu->PC++;
-
-	// Cycle 1: Set D
-	cpu->SR |= D;
-
-	// Swap arithmetic handlers
-	execute[0x69] = do_ADC_imm_BCD;
-	execute[0x6D] = do_ADC_abs_BCD;
-	execute[0x7D] = do_ADC_absX_BCD;
-	execute[0x79] = do_ADC_absY_BCD;
-	execute[0x65] = do_ADC_zpg_BCD;
-	execute[0x75] = do_ADC_zpgX_BCD;
-	execute[0x61] = do_ADC_Xind_BCD;
-	execute[0x71] = do_ADC_indY_BCD;
-	execute[0xE9] = do_SBC_imm_BCD;
-	execute[0xED] = do_SBC_abs_BCD;
-	execute[0xFD] = do_SBC_absX_BCD;
-	execute[0xF9] = do_SBC_absY_BCD;
-	execute[0xE5] = do_SBC_zpg_BCD;
-	execute[0xF5] = do_SBC_zpgX_BCD;
-	execute[0xE1] = do_SBC_Xind_BCD;
-	execute[0xF1] = do_SBC_indY_BCD;
-
-	opr.operand = 0;
-	opr.result = cpu->SR;
+do_BRK_impl, 	// 0x00
+do_ORA_Xind, 	// 0x01
+do_NOP_impl, 	// 0x02
+do_NOP_impl, 	// 0x03
+do_NOP_impl, 	// 0x04
+do_ORA_zpg, 	// 0x05
+do_ASL_zpg, 	// 0x06
+do_NOP_impl, 	// 0x07
+do_PHP_impl, 	// 0x08
+do_ORA_imm, 	// 0x09
+do_ASL_A,	 	// 0x0A
+do_NOP_impl, 	// 0x0B
+do_NOP_impl, 	// 0x0C
+do_ORA_abs, 	// 0x0D
+do_ASL_abs, 	// 0x0E
+do_NOP_impl, 	// 0x0F
+do_BPL_rel, 	// 0x10
+do_ORA_indY, 	// 0x11
+do_NOP_impl, 	// 0x12
+do_NOP_impl, 	// 0x13
+do_NOP_impl, 	// 0x14
+do_ORA_zpgX, 	// 0x15
+do_ASL_zpgX, 	// 0x16
+do_NOP_impl, 	// 0x17
+do_CLC_impl, 	// 0x18
+do_ORA_absY, 	// 0x19
+do_NOP_impl, 	// 0x1A
+do_NOP_impl, 	// 0x1B
+do_NOP_impl, 	// 0x1C
+do_ORA_absX, 	// 0x1D
+do_ASL_absX, 	// 0x1E
+do_NOP_impl, 	// 0x1F
+do_JSR_abs, 	// 0x20
+do_AND_Xind, 	// 0x21
+do_NOP_impl, 	// 0x22
+do_NOP_impl, 	// 0x23
+do_BIT_zpg, 	// 0x24
+do_AND_zpg, 	// 0x25
+do_ROL_zpg, 	// 0x26
+do_NOP_impl, 	// 0x27
+do_PLP_impl, 	// 0x28
+do_AND_imm, 	// 0x29
+do_ROL_A, 		// 0x2A
+do_NOP_impl, 	// 0x2B
+do_BIT_abs, 	// 0x2C
+do_AND_abs, 	// 0x2D
+do_ROL_abs, 	// 0x2E
+do_NOP_impl, 	// 0x2F
+do_BMI_rel, 	// 0x30
+do_AND_indY, 	// 0x31
+do_NOP_impl, 	// 0x32
+do_NOP_impl, 	// 0x33
+do_NOP_impl, 	// 0x34
+do_AND_zpgX, 	// 0x35
+do_ROL_zpgX, 	// 0x36
+do_NOP_impl, 	// 0x37
+do_SEC_impl, 	// 0x38
+do_AND_absY, 	// 0x39
+do_NOP_impl, 	// 0x3A
+do_NOP_impl, 	// 0x3B
+do_NOP_impl, 	// 0x3C
+do_AND_absX, 	// 0x3D
+do_ROL_absX, 	// 0x3E
+do_NOP_impl, 	// 0x3F
+do_RTI_impl, 	// 0x40
+do_EOR_Xind, 	// 0x41
+do_NOP_impl, 	// 0x42
+do_NOP_impl, 	// 0x43
+do_NOP_impl, 	// 0x44
+do_EOR_zpg, 	// 0x45
+do_LSR_zpg, 	// 0x46
+do_NOP_impl, 	// 0x47
+do_PHA_impl, 	// 0x48
+do_EOR_imm, 	// 0x49
+do_LSR_A, 		// 0x4A
+do_NOP_impl, 	// 0x4B
+do_JMP_abs, 	// 0x4C
+do_EOR_abs, 	// 0x4D
+do_LSR_abs, 	// 0x4E
+do_NOP_impl, 	// 0x4F
+do_BVC_rel, 	// 0x50
+do_EOR_indY, 	// 0x51
+do_NOP_impl, 	// 0x52
+do_NOP_impl, 	// 0x53
+do_NOP_impl, 	// 0x54
+do_EOR_zpgX, 	// 0x55
+do_LSR_zpgX, 	// 0x56
+do_NOP_impl, 	// 0x57
+do_CLI_impl, 	// 0x58
+do_EOR_absY, 	// 0x59
+do_NOP_impl, 	// 0x5A
+do_NOP_impl, 	// 0x5B
+do_NOP_impl, 	// 0x5C
+do_EOR_absX, 	// 0x5D
+do_LSR_absX, 	// 0x5E
+do_NOP_impl, 	// 0x5F
+do_RTS_impl, 	// 0x60
+do_ADC_Xind_BCD, 	// 0x61
+do_NOP_impl, 	// 0x62
+do_NOP_impl, 	// 0x63
+do_NOP_impl, 	// 0x64
+do_ADC_zpg_BCD, 	// 0x65
+do_ROR_zpg, 	// 0x66
+do_NOP_impl, 	// 0x67
+do_PLA_impl, 	// 0x68
+do_ADC_imm_BCD, 	// 0x69
+do_ROR_A, 		// 0x6A
+do_NOP_impl, 	// 0x6B
+do_JMP_ind, 	// 0x6C
+do_ADC_abs_BCD, 	// 0x6D
+do_ROR_abs, 	// 0x6E
+do_NOP_impl, 	// 0x6F
+do_BVS_rel, 	// 0x70
+do_ADC_indY_BCD, 	// 0x71
+do_NOP_impl, 	// 0x72
+do_NOP_impl, 	// 0x73
+do_NOP_impl, 	// 0x74
+do_ADC_zpgX_BCD, 	// 0x75
+do_ROR_zpgX, 	// 0x76
+do_NOP_impl, 	// 0x77
+do_SEI_impl, 	// 0x78
+do_ADC_absY_BCD, 	// 0x79
+do_NOP_impl, 	// 0x7A
+do_NOP_impl, 	// 0x7B
+do_NOP_impl, 	// 0x7C
+do_ADC_absX_BCD, 	// 0x7D
+do_ROR_absX, 	// 0x7E
+do_NOP_impl, 	// 0x7F
+do_NOP_impl, 	// 0x80
+do_STA_Xind, 	// 0x81
+do_NOP_impl, 	// 0x82
+do_NOP_impl, 	// 0x83
+do_STY_zpg, 	// 0x84
+do_STA_zpg, 	// 0x85
+do_STX_zpg, 	// 0x86
+do_NOP_impl, 	// 0x87
+do_DEY_impl, 	// 0x88
+do_NOP_impl, 	// 0x89
+do_TXA_impl, 	// 0x8A
+do_NOP_impl, 	// 0x8B
+do_STY_abs, 	// 0x8C
+do_STA_abs, 	// 0x8D
+do_STX_abs, 	// 0x8E
+do_NOP_impl, 	// 0x8F
+do_BCC_rel, 	// 0x90
+do_STA_indY, 	// 0x91
+do_NOP_impl, 	// 0x92
+do_NOP_impl, 	// 0x93
+do_STY_zpgX, 	// 0x94
+do_STA_zpgX, 	// 0x95
+do_STX_zpgY, 	// 0x96
+do_NOP_impl, 	// 0x97
+do_TYA_impl, 	// 0x98
+do_STA_absY, 	// 0x99
+do_TXS_impl, 	// 0x9A
+do_NOP_impl, 	// 0x9B
+do_NOP_impl, 	// 0x9C
+do_STA_absX, 	// 0x9D
+do_NOP_impl, 	// 0x9E
+do_NOP_impl, 	// 0x9F
+do_LDY_imm, 	// 0xA0
+do_LDA_Xind, 	// 0xA1
+do_LDX_imm, 	// 0xA2
+do_NOP_impl, 	// 0xA3
+do_LDY_zpg, 	// 0xA4
+do_LDA_zpg, 	// 0xA5
+do_LDX_zpg, 	// 0xA6
+do_NOP_impl, 	// 0xA7
+do_TAY_impl, 	// 0xA8
+do_LDA_imm, 	// 0xA9
+do_TAX_impl, 	// 0xAA
+do_NOP_impl, 	// 0xAB
+do_LDY_abs, 	// 0xAC
+do_LDA_abs, 	// 0xAD
+do_LDX_abs, 	// 0xAE
+do_NOP_impl, 	// 0xAF
+do_BCS_rel, 	// 0xB0
+do_LDA_indY, 	// 0xB1
+do_NOP_impl, 	// 0xB2
+do_NOP_impl, 	// 0xB3
+do_LDY_zpgX, 	// 0xB4
+do_LDA_zpgX, 	// 0xB5
+do_LDX_zpgY, 	// 0xB6
+do_NOP_impl, 	// 0xB7
+do_CLV_impl, 	// 0xB8
+do_LDA_absY, 	// 0xB9
+do_TSX_impl, 	// 0xBA
+do_NOP_impl, 	// 0xBB
+do_LDY_absX, 	// 0xBC
+do_LDA_absX, 	// 0xBD
+do_LDX_absY, 	// 0xBE
+do_NOP_impl, 	// 0xBF
+do_CPY_imm, 	// 0xC0
+do_CMP_Xind, 	// 0xC1
+do_NOP_impl, 	// 0xC2
+do_NOP_impl, 	// 0xC3
+do_CPY_zpg, 	// 0xC4
+do_CMP_zpg, 	// 0xC5
+do_DEC_zpg, 	// 0xC6
+do_NOP_impl, 	// 0xC7
+do_INY_impl, 	// 0xC8
+do_CMP_imm, 	// 0xC9
+do_DEX_impl, 	// 0xCA
+do_NOP_impl, 	// 0xCB
+do_CPY_abs, 	// 0xCC
+do_CMP_abs, 	// 0xCD
+do_DEC_abs, 	// 0xCE
+do_NOP_impl, 	// 0xCF
+do_BNE_rel, 	// 0xD0
+do_CMP_indY, 	// 0xD1
+do_NOP_impl, 	// 0xD2
+do_NOP_impl, 	// 0xD3
+do_NOP_impl, 	// 0xD4
+do_CMP_zpgX, 	// 0xD5
+do_DEC_zpgX, 	// 0xD6
+do_NOP_impl, 	// 0xD7
+do_CLD_impl, 	// 0xD8
+do_CMP_absY, 	// 0xD9
+do_NOP_impl, 	// 0xDA
+do_NOP_impl, 	// 0xDB
+do_NOP_impl, 	// 0xDC
+do_CMP_absX, 	// 0xDD
+do_DEC_absX, 	// 0xDE
+do_NOP_impl, 	// 0xDF
+do_CPX_imm, 	// 0xE0
+do_SBC_Xind_BCD, 	// 0xE1
+do_NOP_impl, 	// 0xE2
+do_NOP_impl, 	// 0xE3
+do_CPX_zpg, 	// 0xE4
+do_SBC_zpg_BCD, 	// 0xE5
+do_INC_zpg, 	// 0xE6
+do_NOP_impl, 	// 0xE7
+do_INX_impl, 	// 0xE8
+do_SBC_imm_BCD, 	// 0xE9
+do_NOP_impl, 	// 0xEA
+do_NOP_impl, 	// 0xEB
+do_CPX_abs, 	// 0xEC
+do_SBC_abs_BCD, 	// 0xED
+do_INC_abs, 	// 0xEE
+do_NOP_impl, 	// 0xEF
+do_BEQ_rel, 	// 0xF0
+do_SBC_indY_BCD, 	// 0xF1
+do_NOP_impl, 	// 0xF2
+do_NOP_impl, 	// 0xF3
+do_NOP_impl, 	// 0xF4
+do_SBC_zpgX_BCD, 	// 0xF5
+do_INC_zpgX, 	// 0xF6
+do_NOP_impl, 	// 0xF7
+do_SED_impl, 	// 0xF8
+do_SBC_absY_BCD, 	// 0xF9
+do_NOP_impl, 	// 0xFA
+do_NOP_impl, 	// 0xFB
+do_NOP_impl, 	// 0xFC
+do_SBC_absX_BCD, 	// 0xFD
+do_INC_absX, 	// 0xFE
+do_NOP_impl  	// 0xFF
+};
 
-	return opr;
-}
+// Instruction length in bytes, for engines that decode ahead
+// 	Undefined opcodes run as 1 byte NOPs
+const byte op_length[256] =
+{
+	1, 2, 1, 1, 1, 2, 2, 1, 1, 2, 1, 1, 1, 3, 3, 1,	// 0x00
+	2, 2, 1, 1, 1, 2, 2, 1, 1, 3, 1, 1, 1, 3, 3, 1,	// 0x10
+	3, 2, 1, 1, 2, 2, 2, 1, 1, 2, 1, 1, 3, 3, 3, 1,	// 0x20
+	2, 2, 1, 1, 1, 2, 2, 1, 1, 3, 1, 1, 1, 3, 3, 1,	// 0x30
+	1, 2, 1, 1, 1, 2, 2, 1, 1, 2, 1, 1, 3, 3, 3, 1,	// 0x40
+	2, 2, 1, 1, 1, 2, 2, 1, 1, 3, 1, 1, 1, 3, 3, 1,	// 0x50
+	1, 2, 1, 1, 1, 2, 2, 1, 1, 2, 1, 1, 3, 3, 3, 1,	// 0x60
+	2, 2, 1, 1, 1, 2, 2, 1, 1, 3, 1, 1, 1, 3, 3, 1,	// 0x70
+	1, 2, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 3, 3, 3, 1,	// 0x80
+	2, 2, 1, 1, 2, 2, 2, 1, 1, 3, 1, 1, 1, 3, 1, 1,	// 0x90
+	2, 2, 2, 1, 2, 2, 2, 1, 1, 2, 1, 1, 3, 3, 3, 1,	// 0xA0
+	2, 2, 1, 1, 2, 2, 2, 1, 1, 3, 1, 1, 3, 3, 3, 1,	// 0xB0
+	2, 2, 1, 1, 2, 2, 2, 1, 1, 2, 1, 1, 3, 3, 3, 1,	// 0xC0
+	2, 2, 1, 1, 1, 2, 2, 1, 1, 3, 1, 1, 1, 3, 3, 1,	// 0xD0
+	2, 2, 1, 1, 2, 2, 2, 1, 1, 2, 1, 1, 3, 3, 3, 1,	// 0xE0
+	2, 2, 1, 1, 1, 2, 2, 1, 1, 3, 1, 1, 1, 3, 3, 1	// 0xF0
+};
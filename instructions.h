@@ -27,6 +27,11 @@ void set_print_trace(int pt);
 
 struct opreturn test_op();
 
+// Instruction tables
+extern const ophandler execute_binary[256];
+extern const ophandler execute_decimal[256];
+extern const byte op_length[256];
+
 // Instruction handler functions
 struct opreturn do_BRK_impl(CPU *cpu);	// 0x00
 struct opreturn do_ORA_Xind(CPU *cpu);	// 0x01
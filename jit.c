@@ -0,0 +1,1436 @@
+// jit.c
+//
+// 6502 emulator program
+// 	x86-64 dynamic translation engine
+//
+// Brian K. Niece
+//
+// A fourth execution engine.  Each address that starts a block is counted
+// 	as it is reached, and once it has been reached JIT_HOT times the
+// 	block is translated into x86-64 machine code in an executable buffer.
+// 	Until then, and for instructions that are never translated (BRK and
+// 	RTI), the table handlers run one instruction at a time.
+//
+// Translated code keeps the 6502 registers in host registers for the
+// 	length of a block:
+// 		A - r12d, X - r13d, Y - r14d, SR - r15d, SP - ebx
+// 	Each holds a zero extended byte.  rbp points to the jit_ctx, and
+// 	eax, ecx, edx, esi and edi are scratch.  The registers are loaded from
+// 	the CPU when a block starts and stored back when it ends, so the table
+// 	handlers always see the current state between blocks.
+//
+// Memory reads of plain RAM go straight through the bus page table; all
+// 	other reads, and every write, call back into C.  ADC and SBC call C
+// 	as well, which keeps the BCD rules in one place (opcore.h).
+//
+// A block that ends at a known address, or at an address computed by RTS
+// 	or JMP (ind), jumps straight to the translation for that address
+// 	through the body[] table.  Addresses without one lead to common code
+// 	that stores the registers and returns to run_jit().  In check mode
+// 	every block returns so it can be compared.
+//
+// Cycle counts follow the instruction bodies in opbodies.h: the fixed
+// 	part of each instruction is added when the block exits, and the
+// 	page crossing and branch penalties are added as they happen.
+//
+// Code isn't write protected.  Pages that translated code came from are
+// 	marked PG_CODE, so any write to them reaches jit_code_write(), which
+// 	drops the blocks from that page and ends the running block after the
+// 	instruction that did the write.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jit.h"
+#include "blockcache.h"
+#include "instructions.h"
+#include "membus.h"
+#include "opcore.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define JIT_X86_64
+#include <sys/mman.h>
+#endif
+
+#ifdef JIT_X86_64
+
+// Times an address must start a block before it is translated
+#define JIT_HOT 2
+
+// Longest run of instructions translated into one block
+#define JIT_MAX_OPS 32
+
+// Size of the code buffer, and the most a single block could need
+#define JIT_CODE_SIZE (4 * 1024 * 1024)
+#define JIT_BLOCK_ROOM (32 * 1024)
+
+// Instruction kinds
+enum
+{
+	J_UNDEF = 0,	// undefined opcodes run as NOP
+	J_ADC, J_AND, J_ASL, J_BCC, J_BCS, J_BEQ, J_BIT, J_BMI, J_BNE, J_BPL,
+	J_BRK, J_BVC, J_BVS, J_CLC, J_CLD, J_CLI, J_CLV, J_CMP, J_CPX, J_CPY,
+	J_DEC, J_DEX, J_DEY, J_EOR, J_INC, J_INX, J_INY, J_JMP, J_JMPI, J_JSR,
+	J_LDA, J_LDX, J_LDY, J_LSR, J_NOP, J_ORA, J_PHA, J_PHP, J_PLA, J_PLP,
+	J_ROL, J_ROR, J_RTI, J_RTS, J_SBC, J_SEC, J_SED, J_SEI, J_STA, J_STX,
+	J_STY, J_TAX, J_TAY, J_TSX, J_TXA, J_TXS, J_TYA
+};
+
+// Addressing modes
+enum
+{
+	M_IMP = 0, M_ACC, M_IMM, M_ZPG, M_ZPX, M_ZPY, M_ABS, M_ABX, M_ABY,
+	M_XIND, M_INDY, M_REL, M_IND
+};
+
+struct jit_op
+{
+	byte kind;
+	byte mode;
+	byte cycles;	// fixed cycle count
+	byte cross;		// 1 if crossing a page while indexing adds a cycle
+};
+
+// Same cycle counts as opbodies.h
+static const struct jit_op jit_ops[256] =
+{
+	[0x00] = { J_BRK, M_IMP, 7, 0 },
+	[0x01] = { J_ORA, M_XIND, 6, 0 },
+	[0x05] = { J_ORA, M_ZPG, 3, 0 },
+	[0x06] = { J_ASL, M_ZPG, 5, 0 },
+	[0x08] = { J_PHP, M_IMP, 3, 0 },
+	[0x09] = { J_ORA, M_IMM, 2, 0 },
+	[0x0A] = { J_ASL, M_ACC, 2, 0 },
+	[0x0D] = { J_ORA, M_ABS, 4, 0 },
+	[0x0E] = { J_ASL, M_ABS, 6, 0 },
+	[0x10] = { J_BPL, M_REL, 2, 0 },
+	[0x11] = { J_ORA, M_INDY, 5, 1 },
+	[0x15] = { J_ORA, M_ZPX, 4, 0 },
+	[0x16] = { J_ASL, M_ZPX, 6, 0 },
+	[0x18] = { J_CLC, M_IMP, 2, 0 },
+	[0x19] = { J_ORA, M_ABY, 4, 1 },
+	[0x1D] = { J_ORA, M_ABX, 4, 1 },
+	[0x1E] = { J_ASL, M_ABX, 7, 0 },
+	[0x20] = { J_JSR, M_ABS, 6, 0 },
+	[0x21] = { J_AND, M_XIND, 6, 0 },
+	[0x24] = { J_BIT, M_ZPG, 3, 0 },
+	[0x25] = { J_AND, M_ZPG, 3, 0 },
+	[0x26] = { J_ROL, M_ZPG, 5, 0 },
+	[0x28] = { J_PLP, M_IMP, 4, 0 },
+	[0x29] = { J_AND, M_IMM, 2, 0 },
+	[0x2A] = { J_ROL, M_ACC, 2, 0 },
+	[0x2C] = { J_BIT, M_ABS, 4, 0 },
+	[0x2D] = { J_AND, M_ABS, 4, 0 },
+	[0x2E] = { J_ROL, M_ABS, 6, 0 },
+	[0x30] = { J_BMI, M_REL, 2, 0 },
+	[0x31] = { J_AND, M_INDY, 5, 1 },
+	[0x35] = { J_AND, M_ZPX, 4, 0 },
+	[0x36] = { J_ROL, M_ZPX, 6, 0 },
+	[0x38] = { J_SEC, M_IMP, 2, 0 },
+	[0x39] = { J_AND, M_ABY, 4, 1 },
+	[0x3D] = { J_AND, M_ABX, 4, 1 },
+	[0x3E] = { J_ROL, M_ABX, 7, 0 },
+	[0x40] = { J_RTI, M_IMP, 6, 0 },
+	[0x41] = { J_EOR, M_XIND, 6, 0 },
+	[0x45] = { J_EOR, M_ZPG, 3, 0 },
+	[0x46] = { J_LSR, M_ZPG, 5, 0 },
+	[0x48] = { J_PHA, M_IMP, 3, 0 },
+	[0x49] = { J_EOR, M_IMM, 2, 0 },
+	[0x4A] = { J_LSR, M_ACC, 2, 0 },
+	[0x4C] = { J_JMP, M_ABS, 3, 0 },
+	[0x4D] = { J_EOR, M_ABS, 4, 0 },
+	[0x4E] = { J_LSR, M_ABS, 6, 0 },
+	[0x50] = { J_BVC, M_REL, 2, 0 },
+	[0x51] = { J_EOR, M_INDY, 5, 1 },
+	[0x55] = { J_EOR, M_ZPX, 4, 0 },
+	[0x56] = { J_LSR, M_ZPX, 6, 0 },
+	[0x58] = { J_CLI, M_IMP, 2, 0 },
+	[0x59] = { J_EOR, M_ABY, 4, 1 },
+	[0x5D] = { J_EOR, M_ABX, 4, 1 },
+	[0x5E] = { J_LSR, M_ABX, 7, 0 },
+	[0x60] = { J_RTS, M_IMP, 6, 0 },
+	[0x61] = { J_ADC, M_XIND, 6, 0 },
+	[0x65] = { J_ADC, M_ZPG, 3, 0 },
+	[0x66] = { J_ROR, M_ZPG, 5, 0 },
+	[0x68] = { J_PLA, M_IMP, 4, 0 },
+	[0x69] = { J_ADC, M_IMM, 2, 0 },
+	[0x6A] = { J_ROR, M_ACC, 2, 0 },
+	[0x6C] = { J_JMPI, M_IND, 5, 0 },
+	[0x6D] = { J_ADC, M_ABS, 4, 0 },
+	[0x6E] = { J_ROR, M_ABS, 6, 0 },
+	[0x70] = { J_BVS, M_REL, 2, 0 },
+	[0x71] = { J_ADC, M_INDY, 5, 1 },
+	[0x75] = { J_ADC, M_ZPX, 4, 0 },
+	[0x76] = { J_ROR, M_ZPX, 6, 0 },
+	[0x78] = { J_SEI, M_IMP, 2, 0 },
+	[0x79] = { J_ADC, M_ABY, 4, 1 },
+	[0x7D] = { J_ADC, M_ABX, 4, 1 },
+	[0x7E] = { J_ROR, M_ABX, 7, 0 },
+	[0x81] = { J_STA, M_XIND, 6, 0 },
+	[0x84] = { J_STY, M_ZPG, 3, 0 },
+	[0x85] = { J_STA, M_ZPG, 3, 0 },
+	[0x86] = { J_STX, M_ZPG, 3, 0 },
+	[0x88] = { J_DEY, M_IMP, 2, 0 },
+	[0x8A] = { J_TXA, M_IMP, 2, 0 },
+	[0x8C] = { J_STY, M_ABS, 4, 0 },
+	[0x8D] = { J_STA, M_ABS, 4, 0 },
+	[0x8E] = { J_STX, M_ABS, 4, 0 },
+	[0x90] = { J_BCC, M_REL, 2, 0 },
+	[0x91] = { J_STA, M_INDY, 6, 0 },
+	[0x94] = { J_STY, M_ZPX, 4, 0 },
+	[0x95] = { J_STA, M_ZPX, 4, 0 },
+	[0x96] = { J_STX, M_ZPY, 4, 0 },
+	[0x98] = { J_TYA, M_IMP, 2, 0 },
+	[0x99] = { J_STA, M_ABY, 5, 0 },
+	[0x9A] = { J_TXS, M_IMP, 2, 0 },
+	[0x9D] = { J_STA, M_ABX, 5, 0 },
+	[0xA0] = { J_LDY, M_IMM, 2, 0 },
+	[0xA1] = { J_LDA, M_XIND, 6, 0 },
+	[0xA2] = { J_LDX, M_IMM, 2, 0 },
+	[0xA4] = { J_LDY, M_ZPG, 3, 0 },
+	[0xA5] = { J_LDA, M_ZPG, 3, 0 },
+	[0xA6] = { J_LDX, M_ZPG, 3, 0 },
+	[0xA8] = { J_TAY, M_IMP, 2, 0 },
+	[0xA9] = { J_LDA, M_IMM, 2, 0 },
+	[0xAA] = { J_TAX, M_IMP, 2, 0 },
+	[0xAC] = { J_LDY, M_ABS, 4, 0 },
+	[0xAD] = { J_LDA, M_ABS, 4, 0 },
+	[0xAE] = { J_LDX, M_ABS, 4, 0 },
+	[0xB0] = { J_BCS, M_REL, 2, 0 },
+	[0xB1] = { J_LDA, M_INDY, 5, 1 },
+	[0xB4] = { J_LDY, M_ZPX, 4, 0 },
+	[0xB5] = { J_LDA, M_ZPX, 4, 0 },
+	[0xB6] = { J_LDX, M_ZPY, 4, 0 },
+	[0xB8] = { J_CLV, M_IMP, 2, 0 },
+	[0xB9] = { J_LDA, M_ABY, 4, 1 },
+	[0xBA] = { J_TSX, M_IMP, 2, 0 },
+	[0xBC] = { J_LDY, M_ABX, 4, 1 },
+	[0xBD] = { J_LDA, M_ABX, 4, 1 },
+	[0xBE] = { J_LDX, M_ABY, 4, 1 },
+	[0xC0] = { J_CPY, M_IMM, 2, 0 },
+	[0xC1] = { J_CMP, M_XIND, 6, 0 },
+	[0xC4] = { J_CPY, M_ZPG, 3, 0 },
+	[0xC5] = { J_CMP, M_ZPG, 3, 0 },
+	[0xC6] = { J_DEC, M_ZPG, 5, 0 },
+	[0xC8] = { J_INY, M_IMP, 2, 0 },
+	[0xC9] = { J_CMP, M_IMM, 2, 0 },
+	[0xCA] = { J_DEX, M_IMP, 2, 0 },
+	[0xCC] = { J_CPY, M_ABS, 4, 0 },
+	[0xCD] = { J_CMP, M_ABS, 4, 0 },
+	[0xCE] = { J_DEC, M_ABS, 6, 0 },
+	[0xD0] = { J_BNE, M_REL, 2, 0 },
+	[0xD1] = { J_CMP, M_INDY, 5, 1 },
+	[0xD5] = { J_CMP, M_ZPX, 4, 0 },
+	[0xD6] = { J_DEC, M_ZPX, 6, 0 },
+	[0xD8] = { J_CLD, M_IMP, 2, 0 },
+	[0xD9] = { J_CMP, M_ABY, 4, 1 },
+	[0xDD] = { J_CMP, M_ABX, 4, 1 },
+	[0xDE] = { J_DEC, M_ABX, 7, 0 },
+	[0xE0] = { J_CPX, M_IMM, 2, 0 },
+	[0xE1] = { J_SBC, M_XIND, 6, 0 },
+	[0xE4] = { J_CPX, M_ZPG, 3, 0 },
+	[0xE5] = { J_SBC, M_ZPG, 3, 0 },
+	[0xE6] = { J_INC, M_ZPG, 5, 0 },
+	[0xE8] = { J_INX, M_IMP, 2, 0 },
+	[0xE9] = { J_SBC, M_IMM, 2, 0 },
+	[0xEA] = { J_NOP, M_IMP, 2, 0 },
+	[0xEC] = { J_CPX, M_ABS, 4, 0 },
+	[0xED] = { J_SBC, M_ABS, 4, 0 },
+	[0xEE] = { J_INC, M_ABS, 6, 0 },
+	[0xF0] = { J_BEQ, M_REL, 2, 0 },
+	[0xF1] = { J_SBC, M_INDY, 5, 1 },
+	[0xF5] = { J_SBC, M_ZPX, 4, 0 },
+	[0xF6] = { J_INC, M_ZPX, 6, 0 },
+	[0xF8] = { J_SED, M_IMP, 2, 0 },
+	[0xF9] = { J_SBC, M_ABY, 4, 1 },
+	[0xFD] = { J_SBC, M_ABX, 4, 1 },
+	[0xFE] = { J_INC, M_ABX, 7, 0 },
+};
+
+// Host registers
+enum
+{
+	RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+	R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+#define RA	R12
+#define RX	R13
+#define RY	R14
+#define RSR	R15
+#define RSP6502	RBX
+
+// Two operand ALU opcodes (r/m32, r32)
+#define ALU_ADD		0x01
+#define ALU_OR		0x09
+#define ALU_AND		0x21
+#define ALU_SUB		0x29
+#define ALU_CMP		0x39
+#define ALU_TEST	0x85
+
+// Opcode extensions for 0x81 (r/m32, imm32) and 0xC1 (shifts)
+#define EXT_ADD	0
+#define EXT_OR	1
+#define EXT_ADC	2
+#define EXT_AND	4
+#define EXT_SUB	5
+#define EXT_SHL	4
+#define EXT_SHR	5
+
+// Condition codes
+#define CC_NE	0x5
+#define CC_E	0x4
+
+typedef void (*jit_block)(void *ctx);
+
+typedef struct jit_ctx
+{
+	// Used by the translated code
+	CPU *cpu;
+	membus *bus;
+	mem_page *pages;
+	unsigned long long cycles;
+	unsigned long long count;
+	byte smc;					// set when a write hits translated code
+	byte nz[256];				// N and Z flags for each value
+	void *body[MAX_MEM];		// code after the prologue of each block
+
+	// Translations
+	byte *code;					// executable buffer
+	byte *code_next;			// next free byte in the buffer
+	byte *leave;				// code that returns to run_jit()
+	int chain;					// 1 to jump between blocks without returning
+	jit_block entry[MAX_MEM];	// block starting at each address
+	word block_end[MAX_MEM];	// last byte of each block
+	byte heat[MAX_MEM];			// times each address started a block
+} jit_ctx;
+
+// Stack slots for values that must survive a call
+#define SLOT0 0
+#define SLOT1 4
+
+// ---------------------------------------------------------------------
+// Calls from translated code
+
+static unsigned jit_read(membus *bus, unsigned addr)
+{
+	return read(bus, addr);
+}
+
+static void jit_write(jit_ctx *ctx, unsigned addr, unsigned data)
+{
+	write(ctx->bus, addr, data);
+}
+
+static unsigned jit_adc(unsigned A, unsigned SR, unsigned M)
+// Add with carry, returns SR in the high byte and A in the low byte
+{
+	byte a = A;
+	byte sr = SR;
+
+	if ((sr & D) != 0)
+	{
+		adc_decimal(&a, &sr, M);
+	}
+	else
+	{
+		int r = a + M + (sr & C);
+		sr &= ~(N | V | Z | C);
+		sr |= (r >> 8) & C;
+		sr |= ((a ^ r) & (M ^ r) & 0x80) ? V : 0;
+		sr |= r & N;
+		sr |= (r & 0xFF) ? 0 : Z;
+		a = r;
+	}
+
+	return (sr << 8) | a;
+}
+
+static unsigned jit_sbc(unsigned A, unsigned SR, unsigned M)
+// Subtract with carry, returns SR in the high byte and A in the low byte
+{
+	byte a = A;
+	byte sr = SR;
+
+	if ((sr & D) != 0)
+	{
+		sbc_decimal(&a, &sr, M);
+		return (sr << 8) | a;
+	}
+
+	return jit_adc(A, SR, ~M & 0xFF);
+}
+
+static void jit_code_write(void *p, word addr, int len)
+// A write landed in a page with translated code, or the page was banked,
+// 	so drop every block that touches the page.  A block is shorter than
+// 	a page, so it can only start in the page or the one before it.
+// 	len is never more than a page, so addr's page covers it.
+{
+	jit_ctx *ctx = p;
+	byte pg = addr >> 8;
+	word start = (byte)(pg - 1) << 8;
+
+	for (int i = 0; i < 2 * PAGE_SIZE; i++, start++)
+	{
+		if ((ctx->entry[start] != NULL) &&
+				(((start >> 8) == pg) || ((ctx->block_end[start] >> 8) == pg)))
+		{
+			ctx->entry[start] = NULL;
+			ctx->body[start] = ctx->leave;
+			ctx->heat[start] = 0;
+		}
+	}
+
+	ctx->bus->pages[pg].attr &= ~PG_CODE;
+	ctx->smc = 1;
+}
+
+// ---------------------------------------------------------------------
+// x86-64 encoding
+
+static void emit8(jit_ctx *ctx, int b)
+{
+	*ctx->code_next++ = b;
+}
+
+static void emit32(jit_ctx *ctx, int v)
+{
+	memcpy(ctx->code_next, &v, 4);
+	ctx->code_next += 4;
+}
+
+static void emit64(jit_ctx *ctx, uint64_t v)
+{
+	memcpy(ctx->code_next, &v, 8);
+	ctx->code_next += 8;
+}
+
+static void emit_rex(jit_ctx *ctx, int w, int r, int x, int b)
+// REX prefix when needed
+// 	Always sent for registers 4-7 so byte operations get spl-dil
+// 	rather than ah-bh.
+{
+	int rex = 0x40 | (w << 3) | ((r & 8) >> 1) | ((x & 8) >> 2) | ((b & 8) >> 3);
+
+	if ((rex != 0x40) || ((r >= 4) && (r < 8)) || ((b >= 4) && (b < 8)))
+	{
+		emit8(ctx, rex);
+	}
+}
+
+static void emit_opcode(jit_ctx *ctx, int opc)
+// One or two byte opcode
+{
+	if (opc > 0xFF)
+	{
+		emit8(ctx, opc >> 8);
+	}
+	emit8(ctx, opc & 0xFF);
+}
+
+static void emit_rr(jit_ctx *ctx, int w, int opc, int r, int b)
+// Register form, r in the reg field and b in the r/m field
+{
+	emit_rex(ctx, w, r, 0, b);
+	emit_opcode(ctx, opc);
+	emit8(ctx, 0xC0 | ((r & 7) << 3) | (b & 7));
+}
+
+static void emit_rm(jit_ctx *ctx, int w, int opc, int r, int base, int index,
+		int disp)
+// Memory form [base + index + disp], index -1 for none
+{
+	emit_rex(ctx, w, r, (index < 0) ? 0 : index, base);
+	emit_opcode(ctx, opc);
+	if ((index >= 0) || ((base & 7) == RSP))
+	{
+		emit8(ctx, 0x84 | ((r & 7) << 3));
+		emit8(ctx, ((((index < 0) ? RSP : index) & 7) << 3) | (base & 7));
+	}
+	else
+	{
+		emit8(ctx, 0x80 | ((r & 7) << 3) | (base & 7));
+	}
+	emit32(ctx, disp);
+}
+
+static void mov_rr(jit_ctx *ctx, int dst, int src)
+{
+	emit_rr(ctx, 0, 0x89, src, dst);
+}
+
+static void mov_ri(jit_ctx *ctx, int dst, int imm)
+{
+	emit_rex(ctx, 0, 0, 0, dst);
+	emit8(ctx, 0xB8 + (dst & 7));
+	emit32(ctx, imm);
+}
+
+static void alu_rr(jit_ctx *ctx, int opc, int dst, int src)
+{
+	emit_rr(ctx, 0, opc, src, dst);
+}
+
+static void alu_ri(jit_ctx *ctx, int ext, int dst, int imm)
+{
+	emit_rr(ctx, 0, 0x81, ext, dst);
+	emit32(ctx, imm);
+}
+
+static void shift_ri(jit_ctx *ctx, int ext, int dst, int n)
+{
+	emit_rr(ctx, 0, 0xC1, ext, dst);
+	emit8(ctx, n);
+}
+
+static void movzx_rr(jit_ctx *ctx, int dst, int src)
+// dst = low byte of src
+{
+	emit_rr(ctx, 0, 0x0FB6, dst, src);
+}
+
+static void add_ctx(jit_ctx *ctx, int offset, int imm)
+// 64 bit counter in the context += imm
+{
+	emit_rm(ctx, 1, 0x81, EXT_ADD, RBP, -1, offset);
+	emit32(ctx, imm);
+}
+
+static void add_ctx_reg(jit_ctx *ctx, int offset, int reg)
+// 64 bit counter in the context += reg
+{
+	emit_rm(ctx, 1, 0x01, reg, RBP, -1, offset);
+}
+
+static byte *emit_jcc(jit_ctx *ctx, int cc)
+// Conditional jump, returns the end of the offset for patch()
+{
+	emit8(ctx, 0x0F);
+	emit8(ctx, 0x80 | cc);
+	emit32(ctx, 0);
+	return ctx->code_next;
+}
+
+static byte *emit_jmp(jit_ctx *ctx)
+{
+	emit8(ctx, 0xE9);
+	emit32(ctx, 0);
+	return ctx->code_next;
+}
+
+static void patch(jit_ctx *ctx, byte *at)
+// Point the jump ending at at to the next instruction emitted
+{
+	int rel = ctx->code_next - at;
+	memcpy(at - 4, &rel, 4);
+}
+
+static void emit_call(jit_ctx *ctx, uint64_t fn)
+// mov rax, fn; call rax
+{
+	emit8(ctx, 0x48);
+	emit8(ctx, 0xB8);
+	emit64(ctx, fn);
+	emit8(ctx, 0xFF);
+	emit8(ctx, 0xD0);
+}
+
+// ---------------------------------------------------------------------
+// 6502 building blocks
+
+static void emit_prologue(jit_ctx *ctx)
+// Save the callee saved registers and load the 6502 registers
+{
+	emit8(ctx, 0x53);						// push rbx
+	emit8(ctx, 0x55);						// push rbp
+	emit8(ctx, 0x41); emit8(ctx, 0x54);		// push r12
+	emit8(ctx, 0x41); emit8(ctx, 0x55);		// push r13
+	emit8(ctx, 0x41); emit8(ctx, 0x56);		// push r14
+	emit8(ctx, 0x41); emit8(ctx, 0x57);		// push r15
+	emit8(ctx, 0x48); emit8(ctx, 0x83);		// sub rsp, 24
+	emit8(ctx, 0xEC); emit8(ctx, 24);		// 	(keeps calls 16 byte aligned)
+	emit_rr(ctx, 1, 0x89, RDI, RBP);		// mov rbp, rdi
+
+	emit_rm(ctx, 1, 0x8B, RAX, RBP, -1, offsetof(jit_ctx, cpu));
+	emit_rm(ctx, 0, 0x0FB6, RA, RAX, -1, offsetof(CPU, A));
+	emit_rm(ctx, 0, 0x0FB6, RX, RAX, -1, offsetof(CPU, X));
+	emit_rm(ctx, 0, 0x0FB6, RY, RAX, -1, offsetof(CPU, Y));
+	emit_rm(ctx, 0, 0x0FB6, RSR, RAX, -1, offsetof(CPU, SR));
+	emit_rm(ctx, 0, 0x0FB6, RSP6502, RAX, -1, offsetof(CPU, SP));
+}
+
+static void emit_leave(jit_ctx *ctx)
+// Store the registers, with the next PC in eax, and return to run_jit()
+{
+	emit_rm(ctx, 1, 0x8B, RCX, RBP, -1, offsetof(jit_ctx, cpu));
+	emit8(ctx, 0x66);
+	emit_rm(ctx, 0, 0x89, RAX, RCX, -1, offsetof(CPU, PC));
+	emit_rm(ctx, 0, 0x88, RA, RCX, -1, offsetof(CPU, A));
+	emit_rm(ctx, 0, 0x88, RX, RCX, -1, offsetof(CPU, X));
+	emit_rm(ctx, 0, 0x88, RY, RCX, -1, offsetof(CPU, Y));
+	emit_rm(ctx, 0, 0x88, RSR, RCX, -1, offsetof(CPU, SR));
+	emit_rm(ctx, 0, 0x88, RSP6502, RCX, -1, offsetof(CPU, SP));
+
+	emit8(ctx, 0x48); emit8(ctx, 0x83);		// add rsp, 24
+	emit8(ctx, 0xC4); emit8(ctx, 24);
+	emit8(ctx, 0x41); emit8(ctx, 0x5F);		// pop r15
+	emit8(ctx, 0x41); emit8(ctx, 0x5E);		// pop r14
+	emit8(ctx, 0x41); emit8(ctx, 0x5D);		// pop r13
+	emit8(ctx, 0x41); emit8(ctx, 0x5C);		// pop r12
+	emit8(ctx, 0x5D);						// pop rbp
+	emit8(ctx, 0x5B);						// pop rbx
+	emit8(ctx, 0xC3);						// ret
+}
+
+static void emit_exit(jit_ctx *ctx, int cycles, int count)
+// Leave the block with the next PC in eax
+// 	Goes straight on to the block at that address if there is one,
+// 	otherwise body[] points to the shared emit_leave() code.
+{
+	if (cycles != 0)
+	{
+		add_ctx(ctx, offsetof(jit_ctx, cycles), cycles);
+	}
+	add_ctx(ctx, offsetof(jit_ctx, count), count);
+
+	// jmp [rbp + rax*8 + body]
+	emit8(ctx, 0xFF);
+	emit8(ctx, 0xA4);
+	emit8(ctx, 0xC5);
+	emit32(ctx, offsetof(jit_ctx, body));
+}
+
+static void emit_exit_to(jit_ctx *ctx, word pc, int cycles, int count)
+{
+	mov_ri(ctx, RAX, pc);
+	emit_exit(ctx, cycles, count);
+}
+
+static void emit_read(jit_ctx *ctx)
+// eax = byte at the address in esi
+{
+	byte *slow, *done;
+
+	// rax = &pages[esi >> 8], sizeof(mem_page) is 16
+	mov_rr(ctx, RAX, RSI);
+	shift_ri(ctx, EXT_SHR, RAX, 8);
+	shift_ri(ctx, EXT_SHL, RAX, 4);
+	emit_rm(ctx, 1, 0x03, RAX, RBP, -1, offsetof(jit_ctx, pages));
+
+	// test byte [rax + attr], PG_READ_SLOW
+	emit_rm(ctx, 0, 0xF6, 0, RAX, -1, offsetof(mem_page, attr));
+	emit8(ctx, PG_READ_SLOW);
+	slow = emit_jcc(ctx, CC_NE);
+
+	// Plain RAM: eax = host[esi & 0xFF]
+	emit_rm(ctx, 1, 0x8B, RAX, RAX, -1, offsetof(mem_page, host));
+	movzx_rr(ctx, RCX, RSI);
+	emit_rm(ctx, 0, 0x0FB6, RAX, RAX, RCX, 0);
+	done = emit_jmp(ctx);
+
+	patch(ctx, slow);
+	emit_rm(ctx, 1, 0x8B, RDI, RBP, -1, offsetof(jit_ctx, bus));
+	emit_call(ctx, (uint64_t)(uintptr_t)jit_read);
+	patch(ctx, done);
+}
+
+static void emit_write(jit_ctx *ctx)
+// Store edx at the address in esi
+{
+	emit_rr(ctx, 1, 0x89, RBP, RDI);		// mov rdi, rbp
+	emit_call(ctx, (uint64_t)(uintptr_t)jit_write);
+}
+
+static void emit_nz_or(jit_ctx *ctx, int reg)
+// SR |= N and Z for the byte in reg
+{
+	emit_rm(ctx, 0, 0x0FB6, RCX, RBP, reg, offsetof(jit_ctx, nz));
+	alu_rr(ctx, ALU_OR, RSR, RCX);
+}
+
+static void emit_nz(jit_ctx *ctx, int reg)
+// Set N and Z for the byte in reg
+{
+	alu_ri(ctx, EXT_AND, RSR, ~(N | Z) & 0xFF);
+	emit_nz_or(ctx, reg);
+}
+
+static void emit_slot_store(jit_ctx *ctx, int slot, int reg)
+{
+	emit_rm(ctx, 0, 0x89, reg, RSP, -1, slot);
+}
+
+static void emit_slot_load(jit_ctx *ctx, int reg, int slot)
+{
+	emit_rm(ctx, 0, 0x8B, reg, RSP, -1, slot);
+}
+
+static void emit_pointer(jit_ctx *ctx, int lo_addr_reg, int hi_mask)
+// eax = 16 bit pointer read from the address in esi and the next one
+// 	The next address wraps within hi_mask (0xFF for zero page)
+{
+	emit_slot_store(ctx, SLOT0, lo_addr_reg);
+	emit_read(ctx);
+	emit_slot_store(ctx, SLOT1, RAX);
+	emit_slot_load(ctx, RSI, SLOT0);
+	alu_ri(ctx, EXT_ADD, RSI, 1);
+	alu_ri(ctx, EXT_AND, RSI, hi_mask);
+	emit_read(ctx);
+	shift_ri(ctx, EXT_SHL, RAX, 8);
+	emit_rm(ctx, 0, 0x0B, RAX, RSP, -1, SLOT1);		// or eax, [rsp + SLOT1]
+}
+
+static void emit_address(jit_ctx *ctx, int mode, word operand, int cross)
+// esi = effective address
+// 	cross adds the cycle for crossing a page while indexing
+{
+	int index;
+
+	switch (mode)
+	{
+		case M_ZPG:
+		case M_ABS:
+			mov_ri(ctx, RSI, operand);
+			break;
+		case M_ZPX:
+		case M_ZPY:
+			mov_rr(ctx, RSI, (mode == M_ZPX) ? RX : RY);
+			alu_ri(ctx, EXT_ADD, RSI, operand);
+			alu_ri(ctx, EXT_AND, RSI, 0xFF);
+			break;
+		case M_ABX:
+		case M_ABY:
+			index = (mode == M_ABX) ? RX : RY;
+			if (cross)
+			{
+				mov_rr(ctx, RAX, index);
+				alu_ri(ctx, EXT_ADD, RAX, operand & 0xFF);
+				shift_ri(ctx, EXT_SHR, RAX, 8);
+				add_ctx_reg(ctx, offsetof(jit_ctx, cycles), RAX);
+			}
+			mov_rr(ctx, RSI, index);
+			alu_ri(ctx, EXT_ADD, RSI, operand);
+			alu_ri(ctx, EXT_AND, RSI, 0xFFFF);
+			break;
+		case M_XIND:
+			mov_rr(ctx, RSI, RX);
+			alu_ri(ctx, EXT_ADD, RSI, operand);
+			alu_ri(ctx, EXT_AND, RSI, 0xFF);
+			emit_pointer(ctx, RSI, 0xFF);
+			mov_rr(ctx, RSI, RAX);
+			break;
+		case M_INDY:
+			mov_ri(ctx, RSI, operand);
+			emit_pointer(ctx, RSI, 0xFF);
+			if (cross)
+			{
+				emit_slot_load(ctx, RCX, SLOT1);
+				alu_rr(ctx, ALU_ADD, RCX, RY);
+				shift_ri(ctx, EXT_SHR, RCX, 8);
+				add_ctx_reg(ctx, offsetof(jit_ctx, cycles), RCX);
+			}
+			mov_rr(ctx, RSI, RAX);
+			alu_rr(ctx, ALU_ADD, RSI, RY);
+			alu_ri(ctx, EXT_AND, RSI, 0xFFFF);
+			break;
+	}
+}
+
+static void emit_operand(jit_ctx *ctx, const struct jit_op *info, word operand)
+// eax = operand value
+{
+	if (info->mode == M_IMM)
+	{
+		mov_ri(ctx, RAX, operand & 0xFF);
+	}
+	else
+	{
+		emit_address(ctx, info->mode, operand, info->cross);
+		emit_read(ctx);
+	}
+}
+
+static void emit_compare(jit_ctx *ctx, int reg)
+// Compare reg with eax, C is set unless reg < eax
+{
+	alu_ri(ctx, EXT_AND, RSR, ~(N | Z | C) & 0xFF);
+	mov_rr(ctx, RCX, reg);
+	alu_rr(ctx, ALU_SUB, RCX, RAX);
+	emit8(ctx, 0xF5);						// cmc
+	alu_ri(ctx, EXT_ADC, RSR, 0);
+	movzx_rr(ctx, RCX, RCX);
+	emit_nz_or(ctx, RCX);
+}
+
+static void emit_shift(jit_ctx *ctx, int kind)
+// Shift or rotate eax, setting N, Z and C
+{
+	if ((kind == J_ROL) || (kind == J_ROR))
+	{
+		mov_rr(ctx, RDX, RSR);
+		alu_ri(ctx, EXT_AND, RDX, C);
+		if (kind == J_ROR)
+		{
+			shift_ri(ctx, EXT_SHL, RDX, 7);
+		}
+	}
+	alu_ri(ctx, EXT_AND, RSR, ~(N | Z | C) & 0xFF);
+	mov_rr(ctx, RCX, RAX);
+	if ((kind == J_ASL) || (kind == J_ROL))
+	{
+		shift_ri(ctx, EXT_SHR, RCX, 7);
+		alu_rr(ctx, ALU_OR, RSR, RCX);
+		shift_ri(ctx, EXT_SHL, RAX, 1);
+	}
+	else
+	{
+		alu_ri(ctx, EXT_AND, RCX, C);
+		alu_rr(ctx, ALU_OR, RSR, RCX);
+		shift_ri(ctx, EXT_SHR, RAX, 1);
+	}
+	if ((kind == J_ROL) || (kind == J_ROR))
+	{
+		alu_rr(ctx, ALU_OR, RAX, RDX);
+	}
+	alu_ri(ctx, EXT_AND, RAX, 0xFF);
+	emit_nz_or(ctx, RAX);
+}
+
+static void emit_push(jit_ctx *ctx)
+// Push edx
+{
+	mov_rr(ctx, RSI, RSP6502);
+	alu_ri(ctx, EXT_OR, RSI, 0x100);
+	emit_write(ctx);
+	alu_ri(ctx, EXT_SUB, RSP6502, 1);
+	alu_ri(ctx, EXT_AND, RSP6502, 0xFF);
+}
+
+static void emit_pull(jit_ctx *ctx)
+// Pull into eax
+{
+	alu_ri(ctx, EXT_ADD, RSP6502, 1);
+	alu_ri(ctx, EXT_AND, RSP6502, 0xFF);
+	mov_rr(ctx, RSI, RSP6502);
+	alu_ri(ctx, EXT_OR, RSI, 0x100);
+	emit_read(ctx);
+}
+
+static int branch_flag(int kind, int *when_set)
+// Flag tested by a branch and whether it branches when the flag is set
+{
+	*when_set = (kind == J_BMI) || (kind == J_BVS) || (kind == J_BCS) ||
+		(kind == J_BEQ);
+
+	switch (kind)
+	{
+		case J_BPL: case J_BMI:
+			return N;
+		case J_BVC: case J_BVS:
+			return V;
+		case J_BCC: case J_BCS:
+			return C;
+		default:
+			return Z;
+	}
+}
+
+static jit_block translate(jit_ctx *ctx, word pc)
+// Translate the block starting at pc
+// 	Returns NULL if the first instruction can't be translated
+{
+	membus *bus = ctx->bus;
+	byte *start = ctx->code_next;
+	word begin = pc;
+	byte *body;
+	int cycles = 0;				// fixed cycles so far
+	int n;
+
+	emit_prologue(ctx);
+	body = ctx->code_next;
+
+	for (n = 0; n < JIT_MAX_OPS; n++)
+	{
+		byte op = read(bus, pc);
+		const struct jit_op *info = &jit_ops[op];
+		int length = op_length[op];
+		word next = pc + length;
+		word operand = 0;
+		int wrote = 0;
+		int flag, when_set;
+		byte *skip;
+
+		// BRK and RTI are left to the table handlers
+		if ((info->kind == J_BRK) || (info->kind == J_RTI))
+		{
+			if (n == 0)
+			{
+				ctx->code_next = start;
+				return NULL;
+			}
+			emit_exit_to(ctx, pc, cycles, n);
+			break;
+		}
+
+		if (length == 2)
+		{
+			operand = read(bus, pc + 1);
+		}
+		else if (length == 3)
+		{
+			operand = read(bus, pc + 1) + (read(bus, pc + 2) << 8);
+		}
+		ctx->block_end[begin] = next - 1;
+
+		if (info->kind == J_UNDEF)
+		{
+			cycles += 2;
+		}
+		else
+		{
+			cycles += info->cycles;
+		}
+
+		switch (info->kind)
+		{
+			// Loads and stores
+			case J_LDA:
+			case J_LDX:
+			case J_LDY:
+			{
+				int reg = (info->kind == J_LDA) ? RA :
+					(info->kind == J_LDX) ? RX : RY;
+				emit_operand(ctx, info, operand);
+				mov_rr(ctx, reg, RAX);
+				emit_nz(ctx, reg);
+				break;
+			}
+			case J_STA:
+			case J_STX:
+			case J_STY:
+				emit_address(ctx, info->mode, operand, 0);
+				mov_rr(ctx, RDX, (info->kind == J_STA) ? RA :
+					(info->kind == J_STX) ? RX : RY);
+				emit_write(ctx);
+				wrote = 1;
+				break;
+
+			// Logical and arithmetic
+			case J_ORA:
+			case J_AND:
+			case J_EOR:
+				emit_operand(ctx, info, operand);
+				alu_rr(ctx, (info->kind == J_ORA) ? ALU_OR :
+					(info->kind == J_AND) ? ALU_AND : 0x31, RA, RAX);
+				emit_nz(ctx, RA);
+				break;
+			case J_ADC:
+			case J_SBC:
+				emit_operand(ctx, info, operand);
+				mov_rr(ctx, RDX, RAX);
+				mov_rr(ctx, RDI, RA);
+				mov_rr(ctx, RSI, RSR);
+				emit_call(ctx, (uint64_t)(uintptr_t)
+					((info->kind == J_ADC) ? jit_adc : jit_sbc));
+				movzx_rr(ctx, RA, RAX);
+				shift_ri(ctx, EXT_SHR, RAX, 8);
+				mov_rr(ctx, RSR, RAX);
+				break;
+			case J_CMP:
+			case J_CPX:
+			case J_CPY:
+				emit_operand(ctx, info, operand);
+				emit_compare(ctx, (info->kind == J_CMP) ? RA :
+					(info->kind == J_CPX) ? RX : RY);
+				break;
+			case J_BIT:
+				emit_operand(ctx, info, operand);
+				alu_ri(ctx, EXT_AND, RSR, ~(N | V | Z) & 0xFF);
+				mov_rr(ctx, RCX, RAX);
+				alu_ri(ctx, EXT_AND, RCX, N | V);
+				alu_rr(ctx, ALU_OR, RSR, RCX);
+				alu_rr(ctx, ALU_TEST, RAX, RA);
+				emit_rr(ctx, 0, 0x0F94, 0, RCX);	// sete cl
+				movzx_rr(ctx, RCX, RCX);
+				shift_ri(ctx, EXT_SHL, RCX, 1);
+				alu_rr(ctx, ALU_OR, RSR, RCX);
+				break;
+
+			// Read, modify, write
+			case J_INC:
+			case J_DEC:
+			case J_ASL:
+			case J_LSR:
+			case J_ROL:
+			case J_ROR:
+				if (info->mode == M_ACC)
+				{
+					mov_rr(ctx, RAX, RA);
+					emit_shift(ctx, info->kind);
+					mov_rr(ctx, RA, RAX);
+					break;
+				}
+				emit_address(ctx, info->mode, operand, 0);
+				emit_slot_store(ctx, SLOT0, RSI);
+				emit_read(ctx);
+				if ((info->kind == J_INC) || (info->kind == J_DEC))
+				{
+					alu_ri(ctx, (info->kind == J_INC) ? EXT_ADD : EXT_SUB,
+						RAX, 1);
+					alu_ri(ctx, EXT_AND, RAX, 0xFF);
+					emit_nz(ctx, RAX);
+				}
+				else
+				{
+					emit_shift(ctx, info->kind);
+				}
+				mov_rr(ctx, RDX, RAX);
+				emit_slot_load(ctx, RSI, SLOT0);
+				emit_write(ctx);
+				wrote = 1;
+				break;
+
+			// Registers
+			case J_INX:
+			case J_INY:
+			case J_DEX:
+			case J_DEY:
+			{
+				int reg = ((info->kind == J_INX) || (info->kind == J_DEX)) ?
+					RX : RY;
+				alu_ri(ctx, ((info->kind == J_INX) || (info->kind == J_INY)) ?
+					EXT_ADD : EXT_SUB, reg, 1);
+				alu_ri(ctx, EXT_AND, reg, 0xFF);
+				emit_nz(ctx, reg);
+				break;
+			}
+			case J_TAX:
+				mov_rr(ctx, RX, RA);
+				emit_nz(ctx, RX);
+				break;
+			case J_TAY:
+				mov_rr(ctx, RY, RA);
+				emit_nz(ctx, RY);
+				break;
+			case J_TXA:
+				mov_rr(ctx, RA, RX);
+				emit_nz(ctx, RA);
+				break;
+			case J_TYA:
+				mov_rr(ctx, RA, RY);
+				emit_nz(ctx, RA);
+				break;
+			case J_TSX:
+				mov_rr(ctx, RX, RSP6502);
+				break;
+			case J_TXS:
+				mov_rr(ctx, RSP6502, RX);
+				break;
+
+			// Stack
+			case J_PHA:
+				mov_rr(ctx, RDX, RA);
+				emit_push(ctx);
+				wrote = 1;
+				break;
+			case J_PHP:
+				mov_rr(ctx, RDX, RSR);
+				alu_ri(ctx, EXT_OR, RDX, B);
+				emit_push(ctx);
+				wrote = 1;
+				break;
+			case J_PLA:
+				emit_pull(ctx);
+				mov_rr(ctx, RA, RAX);
+				emit_nz(ctx, RA);
+				break;
+			case J_PLP:
+				emit_pull(ctx);
+				mov_rr(ctx, RSR, RAX);
+				break;
+
+			// Flags
+			case J_CLC:
+				alu_ri(ctx, EXT_AND, RSR, ~C & 0xFF);
+				break;
+			case J_SEC:
+				alu_ri(ctx, EXT_OR, RSR, C);
+				break;
+			case J_CLI:
+				alu_ri(ctx, EXT_AND, RSR, ~I & 0xFF);
+				break;
+			case J_SEI:
+				alu_ri(ctx, EXT_OR, RSR, I);
+				break;
+			case J_CLV:
+				alu_ri(ctx, EXT_AND, RSR, ~V & 0xFF);
+				break;
+			case J_CLD:
+				alu_ri(ctx, EXT_AND, RSR, ~D & 0xFF);
+				break;
+			case J_SED:
+				alu_ri(ctx, EXT_OR, RSR, D);
+				break;
+
+			case J_NOP:
+			case J_UNDEF:
+				break;
+
+			// Branches end the block
+			// 	Taken branches add 1 cycle, plus 1 more when crossing a page
+			case J_BPL: case J_BMI: case J_BVC: case J_BVS:
+			case J_BCC: case J_BCS: case J_BNE: case J_BEQ:
+			{
+				word target = next + (signed char)operand;
+				int taken = ((next ^ target) & 0xFF00) ? 4 : 3;
+
+				cycles -= info->cycles;
+				flag = branch_flag(info->kind, &when_set);
+				emit_rr(ctx, 0, 0xF7, 0, RSR);		// test r15d, flag
+				emit32(ctx, flag);
+				skip = emit_jcc(ctx, when_set ? CC_E : CC_NE);
+				emit_exit_to(ctx, target, cycles + taken, n + 1);
+				patch(ctx, skip);
+				emit_exit_to(ctx, next, cycles + 2, n + 1);
+				break;
+			}
+
+			// Jumps and returns end the block
+			case J_JMP:
+				emit_exit_to(ctx, operand, cycles, n + 1);
+				break;
+			case J_JMPI:
+				// The pointer high byte doesn't carry into the next page
+				mov_ri(ctx, RSI, operand);
+				emit_read(ctx);
+				emit_slot_store(ctx, SLOT1, RAX);
+				mov_ri(ctx, RSI, (operand & 0xFF00) | ((operand + 1) & 0xFF));
+				emit_read(ctx);
+				shift_ri(ctx, EXT_SHL, RAX, 8);
+				emit_rm(ctx, 0, 0x0B, RAX, RSP, -1, SLOT1);
+				emit_exit(ctx, cycles, n + 1);
+				break;
+			case J_JSR:
+				mov_ri(ctx, RDX, (word)(pc + 2) >> 8);
+				emit_push(ctx);
+				mov_ri(ctx, RDX, (pc + 2) & 0xFF);
+				emit_push(ctx);
+				emit_exit_to(ctx, operand, cycles, n + 1);
+				break;
+			case J_RTS:
+				emit_pull(ctx);
+				emit_slot_store(ctx, SLOT1, RAX);
+				emit_pull(ctx);
+				shift_ri(ctx, EXT_SHL, RAX, 8);
+				emit_rm(ctx, 0, 0x0B, RAX, RSP, -1, SLOT1);
+				alu_ri(ctx, EXT_ADD, RAX, 1);
+				alu_ri(ctx, EXT_AND, RAX, 0xFFFF);
+				emit_exit(ctx, cycles, n + 1);
+				break;
+		}
+
+		if ((info->kind == J_JMP) || (info->kind == J_JMPI) ||
+				(info->kind == J_JSR) || (info->kind == J_RTS) ||
+				(info->mode == M_REL))
+		{
+			n++;
+			break;
+		}
+
+		// A write into translated code ends the block here
+		if (wrote)
+		{
+			emit_rm(ctx, 0, 0x80, 7, RBP, -1, offsetof(jit_ctx, smc));
+			emit8(ctx, 0);						// cmp byte [rbp+smc], 0
+			skip = emit_jcc(ctx, CC_E);
+			emit_rm(ctx, 0, 0xC6, 0, RBP, -1, offsetof(jit_ctx, smc));
+			emit8(ctx, 0);						// mov byte [rbp+smc], 0
+			emit_exit_to(ctx, next, cycles, n + 1);
+			patch(ctx, skip);
+		}
+
+		pc = next;
+		if (n == JIT_MAX_OPS - 1)
+		{
+			emit_exit_to(ctx, pc, cycles, n + 1);
+		}
+	}
+
+	// Mark the pages the block came from
+	// 	(byte so a block at the top of memory wraps to page 0)
+	for (byte pg = begin >> 8; ; pg++)
+	{
+		bus->pages[pg].attr |= PG_CODE;
+		if (pg == (ctx->block_end[begin] >> 8))
+		{
+			break;
+		}
+	}
+
+	ctx->entry[begin] = (jit_block)start;
+	if (ctx->chain)
+	{
+		ctx->body[begin] = body;
+	}
+	return ctx->entry[begin];
+}
+
+static void flush(jit_ctx *ctx)
+// Throw out all translations
+{
+	memset(ctx->entry, 0, sizeof(ctx->entry));
+	memset(ctx->heat, 0, sizeof(ctx->heat));
+	for (int i = 0; i < NUM_PAGES; i++)
+	{
+		ctx->bus->pages[i].attr &= ~PG_CODE;
+	}
+
+	// Start the buffer with the code every block leaves through
+	ctx->code_next = ctx->code;
+	ctx->leave = ctx->code_next;
+	emit_leave(ctx);
+	for (int i = 0; i < MAX_MEM; i++)
+	{
+		ctx->body[i] = ctx->leave;
+	}
+}
+
+static int check_block(CPU *cpu, CPU *shadow, unsigned long long cycles,
+		unsigned long long shadow_cycles, word begin)
+// Compare the machine after a translated block with the shadow copy
+{
+	if ((cpu->PC == shadow->PC) && (cpu->A == shadow->A) &&
+			(cpu->X == shadow->X) && (cpu->Y == shadow->Y) &&
+			(cpu->SP == shadow->SP) && (cpu->SR == shadow->SR) &&
+			(cycles == shadow_cycles) &&
+			(memcmp(cpu->bus->mem, shadow->bus->mem, MAX_MEM) == 0))
+	{
+		return 0;
+	}
+
+	printf("\nJIT check failed in block at 0x%04X\n", begin);
+	printf("         PC    A  X  Y  SP SR  cycles\n");
+	printf("JIT:   %04X  %02X %02X %02X %02X %02X  %llu\n", cpu->PC,
+		cpu->A, cpu->X, cpu->Y, cpu->SP, cpu->SR, cycles);
+	printf("table: %04X  %02X %02X %02X %02X %02X  %llu\n", shadow->PC,
+		shadow->A, shadow->X, shadow->Y, shadow->SP, shadow->SR,
+		shadow_cycles);
+	for (int i = 0; i < MAX_MEM; i++)
+	{
+		if (cpu->bus->mem[i] != shadow->bus->mem[i])
+		{
+			printf("memory 0x%04X: JIT 0x%02X, table 0x%02X\n", i,
+				cpu->bus->mem[i], shadow->bus->mem[i]);
+			break;
+		}
+	}
+
+	return -1;
+}
+
+static byte step(CPU *cpu, unsigned long long *cycles)
+// Run one instruction with the table handlers, returns the opcode
+{
+	struct opreturn opr;
+
+	cpu->IR = read(cpu->bus, cpu->PC);
+	opr = cpu->optable[(cpu->SR & D) != 0][cpu->IR](cpu);
+	*cycles += opr.cycles;
+
+	// Translated code reads SR straight from the CPU
+	update_SR(cpu);
+
+	return cpu->IR;
+}
+
+int jit_available(void)
+{
+	return (sizeof(mem_page) == 16) && (offsetof(mem_page, host) == 0);
+}
+
+int run_jit(CPU *cpu, unsigned long long *cycles_out,
+		unsigned long long *count_out, int check)
+{
+	membus *bus = cpu->bus;
+	jit_ctx *ctx = NULL;
+	int result = 0;
+
+	// Caller's code hook and the pages it marked, put back at the end
+	void (*old_code_write)(void *, word, int) = bus->code_write;
+	void *old_code_ctx = bus->code_ctx;
+	byte had_code[NUM_PAGES];
+
+	// Shadow machine for check mode
+	membus shadow_bus;
+	CPU shadow;
+	unsigned long long shadow_cycles = 0;
+
+	if (jit_available())
+	{
+		ctx = calloc(1, sizeof(jit_ctx));
+	}
+	if (ctx != NULL)
+	{
+		ctx->code = mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ctx->code == MAP_FAILED)
+		{
+			free(ctx);
+			ctx = NULL;
+		}
+	}
+	if (ctx == NULL)
+	{
+		// No translator here, the block cache is the next best thing
+		run_blocks(cpu, cycles_out, count_out);
+		return 0;
+	}
+
+	// The shadow machine would call each device a second time, and only
+	// 	copies the flat memory, not the bank store
+	if (check && ((bus->devices != NULL) || (bus->store != NULL) ||
+			(bus->maps != NULL)))
+	{
+		printf("JIT check can't follow devices or banks, not checking\n");
+		check = 0;
+	}
+
+	for (int i = 0; i < NUM_PAGES; i++)
+	{
+		had_code[i] = bus->pages[i].attr & PG_CODE;
+	}
+
+	update_SR(cpu);
+	ctx->cpu = cpu;
+	ctx->bus = bus;
+	ctx->pages = bus->pages;
+	ctx->chain = !check;
+	flush(ctx);
+	for (int i = 0; i < 256; i++)
+	{
+		ctx->nz[i] = (i & N) | ((i == 0) ? Z : 0);
+	}
+	bus->code_write = jit_code_write;
+	bus->code_ctx = ctx;
+
+	if (check)
+	{
+		shadow_bus = *bus;
+		shadow_bus.code_write = NULL;
+		shadow_bus.code_ctx = NULL;
+		shadow_bus.watch = NULL;
+		shadow_bus.watch_ctx = NULL;
+		shadow_bus.mem = malloc(MAX_MEM);
+		memcpy(shadow_bus.mem, bus->mem, MAX_MEM);
+		for (int i = 0; i < NUM_PAGES; i++)
+		{
+			// Shared pages are read only, so both machines can use them
+			if ((bus->pages[i].host >= bus->mem) &&
+					(bus->pages[i].host < bus->mem + MAX_MEM))
+			{
+				shadow_bus.pages[i].host = shadow_bus.mem +
+					(bus->pages[i].host - bus->mem);
+			}
+		}
+		shadow = *cpu;
+		shadow.bus = &shadow_bus;
+	}
+
+	for (;;)
+	{
+		word pc = cpu->PC;
+		jit_block blk = ctx->entry[pc];
+
+		if ((blk == NULL) && (ctx->heat[pc] < JIT_HOT))
+		{
+			ctx->heat[pc]++;
+			if (ctx->heat[pc] == JIT_HOT)
+			{
+				if ((ctx->code + JIT_CODE_SIZE) - ctx->code_next < JIT_BLOCK_ROOM)
+				{
+					flush(ctx);
+				}
+				blk = translate(ctx, pc);
+			}
+		}
+
+		if (blk != NULL)
+		{
+			unsigned long long start_count = ctx->count;
+
+			ctx->smc = 0;
+			blk(ctx);
+
+			if (check)
+			{
+				for (unsigned long long i = start_count; i < ctx->count; i++)
+				{
+					step(&shadow, &shadow_cycles);
+				}
+				result = check_block(cpu, &shadow, ctx->cycles, shadow_cycles, pc);
+				if (result != 0)
+				{
+					break;
+				}
+			}
+			continue;
+		}
+
+		// Not translated, the table handlers run it
+		ctx->count++;
+		if (check)
+		{
+			step(&shadow, &shadow_cycles);
+		}
+		if (step(cpu, &ctx->cycles) == 0x00)
+		{
+			break;
+		}
+	}
+
+	*cycles_out += ctx->cycles;
+	*count_out += ctx->count;
+
+	// Leave the bus as it was
+	// 	The caller didn't hear about writes to its pages meanwhile, so it
+	// 	is told they may all have changed
+	bus->code_write = old_code_write;
+	bus->code_ctx = old_code_ctx;
+	for (int i = 0; i < NUM_PAGES; i++)
+	{
+		bus->pages[i].attr = (bus->pages[i].attr & ~PG_CODE) | had_code[i];
+		if (had_code[i] != 0)
+		{
+			bus->code_write(bus->code_ctx, i * PAGE_SIZE, PAGE_SIZE);
+		}
+	}
+
+	if (check)
+	{
+		free(shadow_bus.mem);
+	}
+	munmap(ctx->code, JIT_CODE_SIZE);
+	free(ctx);
+
+	return result;
+}
+
+#else
+
+int jit_available(void)
+{
+	return 0;
+}
+
+int run_jit(CPU *cpu, unsigned long long *cycles,
+		unsigned long long *count, int check)
+{
+	run_blocks(cpu, cycles, count);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,27 @@
+// jit.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	x86-64 dynamic translation engine
+//
+// Brian K. Niece
+
+#ifndef JIT_H
+#define JIT_H
+
+#include "cpu.h"
+
+// 1 if this host can run translated code (x86-64, System V calling
+// 	convention), otherwise run_jit() uses the block cache engine
+int jit_available(void);
+
+// Run from cpu->PC until a BRK is executed
+// 	Cycles used and instructions executed are added to *cycles and *count
+// 	With check set to 1, a second copy of the machine follows along on
+// 	the table handlers and is compared after every translated block.
+// 	Check mode is turned off when the bus has devices or a bank store.
+int run_jit(CPU *cpu, unsigned long long *cycles,
+		unsigned long long *count, int check);
+	// returns 0 on success
+	// 		-1 if a translated block didn't match the table handlers
+
+#endif
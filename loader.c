@@ -0,0 +1,583 @@
+// loader.c
+//
+// 6502 emulator program
+// 	Image loader for Intel HEX, S-record, PRG and segment manifests
+//
+// Brian K. Niece
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "loader.h"
+
+#define LINE_LEN 1024
+#define MAX_DEPTH 8		// manifests listing manifests
+
+// A label from an xa label file
+typedef struct label
+{
+	char name[64];
+	word addr;
+	struct label *next;
+} label;
+
+// State for one load_image call
+typedef struct loader
+{
+	membus *bus;
+	load_info *info;
+	long next_addr;		// just past the last byte stored, -1 at the start
+	label *labels;
+	int line;				// line being read in the current text file
+} loader;
+
+// Image formats
+enum { FMT_RAW, FMT_HEX, FMT_SREC, FMT_PRG, FMT_SEG };
+
+static int load_file(loader *ld, char *filename, long addr, int depth);
+
+static int store(loader *ld, long addr, byte *data, int len)
+// Put len bytes at addr, counting a new segment if they don't follow on
+{
+	int i;
+
+	if (addr < 0 || addr + len > MAX_MEM)
+	{
+		return -3;
+	}
+
+	if (addr != ld->next_addr)
+	{
+		ld->info->segments++;
+	}
+	ld->next_addr = addr + len;
+	ld->info->bytes += len;
+
+	for (i = 0; i < len; i++)
+	{
+		poke(ld->bus, addr + i, data[i]);
+	}
+
+	return 0;
+}
+
+static int hex_byte(char *s)
+// returns the 2 hex digits at s, -1 if they aren't
+{
+	int i, val = 0;
+
+	for (i = 0; i < 2; i++)
+	{
+		if (!isxdigit((unsigned char)s[i]))
+		{
+			return -1;
+		}
+		val = (val << 4) | (isdigit((unsigned char)s[i]) ? s[i] - '0' :
+			tolower((unsigned char)s[i]) - 'a' + 10);
+	}
+
+	return val;
+}
+
+static int hex_bytes(char *s, byte *data, int len)
+// Convert len bytes of hex from s
+// returns their sum, -1 if they aren't all there
+{
+	int i, val, sum = 0;
+
+	for (i = 0; i < len; i++)
+	{
+		val = hex_byte(s + 2 * i);
+		if (val < 0)
+		{
+			return -1;
+		}
+		data[i] = val;
+		sum += val;
+	}
+
+	return sum;
+}
+
+static void trim(char *s)
+// Cut trailing white space, including the line end
+{
+	int n = strlen(s);
+
+	while (n > 0 && isspace((unsigned char)s[n - 1]))
+	{
+		s[--n] = '\0';
+	}
+}
+
+static int load_hex(loader *ld, FILE *file)
+// Intel HEX, data, end, and the extended address and start records
+{
+	char buf[LINE_LEN];
+	byte rec[260];
+	long base = 0;
+	int count, addr, type, sum;
+
+	while (fgets(buf, LINE_LEN, file) != NULL)
+	{
+		ld->line++;
+		trim(buf);
+		if (buf[0] == '\0')
+		{
+			continue;
+		}
+
+		// :ccaaaatt data ss
+		if (buf[0] != ':' || (count = hex_byte(buf + 1)) < 0 ||
+				(int)strlen(buf) != 11 + 2 * count)
+		{
+			return -2;
+		}
+		sum = hex_bytes(buf + 1, rec, count + 5);
+		if (sum < 0 || (sum & 0xFF) != 0)
+		{
+			return -2;
+		}
+		addr = (rec[1] << 8) | rec[2];
+		type = rec[3];
+
+		switch (type)
+		{
+			case 0x00:	// data
+				if (store(ld, base + addr, rec + 4, count) < 0)
+				{
+					return -3;
+				}
+				break;
+			case 0x01:	// end of file
+				return 0;
+			case 0x02:	// extended segment address
+			case 0x04:	// extended linear address
+				if (count != 2)
+				{
+					return -2;
+				}
+				base = (rec[4] << 8) | rec[5];
+				base <<= (type == 0x02) ? 4 : 16;
+				break;
+			case 0x03:	// start segment address, CS:IP
+			case 0x05:	// start linear address
+				if (count != 4)
+				{
+					return -2;
+				}
+				if (type == 0x03)
+				{
+					ld->info->entry = (((rec[4] << 8) | rec[5]) << 4) +
+						((rec[6] << 8) | rec[7]);
+				}
+				else
+				{
+					ld->info->entry = ((long)rec[4] << 24) | (rec[5] << 16) |
+						(rec[6] << 8) | rec[7];
+				}
+				if (ld->info->entry < 0 || ld->info->entry >= MAX_MEM)
+				{
+					return -3;
+				}
+				break;
+			default:
+				return -2;
+		}
+	}
+
+	// No end record is fine, the data is all there
+	return 0;
+}
+
+static int load_srec(loader *ld, FILE *file)
+// Motorola S-record, S1-S3 data and S7-S9 start, the rest are skipped
+{
+	// Address bytes for each record type
+	static const int addr_len[10] = { 2, 2, 3, 4, 0, 2, 3, 4, 3, 2 };
+	char buf[LINE_LEN];
+	byte rec[260];
+	long addr;
+	int count, type, sum, alen, i;
+
+	while (fgets(buf, LINE_LEN, file) != NULL)
+	{
+		ld->line++;
+		trim(buf);
+		if (buf[0] == '\0')
+		{
+			continue;
+		}
+
+		// Stt cc aaaa data ss, the count covers address, data and sum
+		if (buf[0] != 'S' || !isdigit((unsigned char)buf[1]) ||
+				(count = hex_byte(buf + 2)) < 0 ||
+				(int)strlen(buf) != 4 + 2 * count)
+		{
+			return -2;
+		}
+		type = buf[1] - '0';
+		alen = addr_len[type];
+		if (type == 4 || count < alen + 1)
+		{
+			return -2;
+		}
+		sum = hex_bytes(buf + 2, rec, count + 1);
+		if (sum < 0 || (sum & 0xFF) != 0xFF)
+		{
+			return -2;
+		}
+		for (addr = 0, i = 0; i < alen; i++)
+		{
+			addr = (addr << 8) | rec[1 + i];
+		}
+
+		switch (type)
+		{
+			case 1:
+			case 2:
+			case 3:
+				if (store(ld, addr, rec + 1 + alen, count - alen - 1) < 0)
+				{
+					return -3;
+				}
+				break;
+			case 7:
+			case 8:
+			case 9:
+				if (addr >= MAX_MEM)
+				{
+					return -3;
+				}
+				ld->info->entry = addr;
+				break;
+			default:	// header and record counts
+				break;
+		}
+	}
+
+	return 0;
+}
+
+static int load_binary(loader *ld, FILE *file, long addr)
+// Raw bytes at addr, or at the address in the first 2 bytes for addr -1
+{
+	byte *data = malloc(MAX_MEM + 1);
+	byte head[2];
+	size_t readbytes;
+	int rc;
+
+	if (addr < 0)
+	{
+		if (fread(head, sizeof(byte), 2, file) != 2)
+		{
+			free(data);
+			return -2;
+		}
+		addr = head[0] | (head[1] << 8);
+	}
+
+	readbytes = fread(data, sizeof(byte), MAX_MEM + 1, file);
+	if (ferror(file))
+	{
+		free(data);
+		return -2;
+	}
+
+	rc = store(ld, addr, data, readbytes);
+	free(data);
+	return rc;
+}
+
+static label *find_label(loader *ld, char *name)
+{
+	label *l;
+
+	for (l = ld->labels; l != NULL; l = l->next)
+	{
+		if (strcmp(l->name, name) == 0)
+		{
+			return l;
+		}
+	}
+
+	return NULL;
+}
+
+static int parse_addr(loader *ld, char *s, long *addr)
+// A hex address, with or without $ or 0x, or a label
+// returns 0 on success, -4 for a label that isn't known
+{
+	char *end;
+	label *l;
+
+	if ((l = find_label(ld, s)) != NULL)
+	{
+		*addr = l->addr;
+		return 0;
+	}
+
+	*addr = strtol(s[0] == '$' ? s + 1 : s, &end, 16);
+	if (*end != '\0' || end == s)
+	{
+		return -4;
+	}
+
+	return 0;
+}
+
+static int load_labels(loader *ld, FILE *file)
+// xa label file, a line for each label: name, 0xaddr, ...
+{
+	char buf[LINE_LEN];
+	char name[64];
+	unsigned int addr;
+	label *l;
+
+	while (fgets(buf, LINE_LEN, file) != NULL)
+	{
+		ld->line++;
+		trim(buf);
+		if (buf[0] == '\0')
+		{
+			continue;
+		}
+
+		if (sscanf(buf, " %63[^, \t] , %x", name, &addr) != 2 ||
+				addr >= MAX_MEM)
+		{
+			return -2;
+		}
+
+		l = malloc(sizeof(label));
+		strcpy(l->name, name);
+		l->addr = addr;
+		l->next = ld->labels;
+		ld->labels = l;
+	}
+
+	return 0;
+}
+
+static void join_path(char *path, char *manifest, char *name)
+// name, from the manifest's directory unless it is absolute
+{
+	char *slash = strrchr(manifest, '/');
+	int dirlen = (slash == NULL) ? 0 : slash - manifest + 1;
+
+	if (name[0] == '/' || dirlen + strlen(name) >= 256)
+	{
+		dirlen = 0;
+	}
+	snprintf(path, 256, "%.*s%s", dirlen, manifest, name);
+}
+
+static int load_manifest(loader *ld, FILE *file, char *filename, int depth)
+// A segment, entry or labels line at a time
+{
+	char buf[LINE_LEN];
+	char first[256], second[256], path[256];
+	char *hash;
+	FILE *lab;
+	long addr;
+	int n, rc, line;
+
+	while (fgets(buf, LINE_LEN, file) != NULL)
+	{
+		line = ++ld->line;
+		if ((hash = strchr(buf, '#')) != NULL)
+		{
+			*hash = '\0';
+		}
+
+		n = sscanf(buf, "%255s %255s", first, second);
+		if (n <= 0)
+		{
+			continue;
+		}
+
+		if (strcmp(first, "entry") == 0)
+		{
+			if (n != 2)
+			{
+				return -2;
+			}
+			if ((rc = parse_addr(ld, second, &addr)) < 0)
+			{
+				return rc;
+			}
+			if (addr < 0 || addr >= MAX_MEM)
+			{
+				return -3;
+			}
+			ld->info->entry = addr;
+			continue;
+		}
+
+		if (n == 2 && strcmp(first, "labels") == 0)
+		{
+			join_path(path, filename, second);
+			lab = fopen(path, "r");
+			if (lab == NULL)
+			{
+				rc = -1;
+			}
+			else
+			{
+				ld->line = 0;
+				rc = load_labels(ld, lab);
+				fclose(lab);
+			}
+		}
+		else
+		{
+			// A segment, the address is only for raw binaries
+			addr = -1;
+			if (n == 2 && (rc = parse_addr(ld, second, &addr)) < 0)
+			{
+				return rc;
+			}
+			join_path(path, filename, first);
+			rc = load_file(ld, path, addr, depth + 1);
+		}
+
+		if (rc < 0)
+		{
+			// Name the inner file if the error was found on one of its lines,
+			// 	or it couldn't be opened
+			if (ld->info->file[0] == '\0' && (rc == -1 || ld->line > 0))
+			{
+				strcpy(ld->info->file, path);
+				ld->info->line = (rc == -1) ? 0 : ld->line;
+			}
+			ld->line = line;
+			return rc;
+		}
+		ld->line = line;
+	}
+
+	return 0;
+}
+
+static int image_format(char *filename, FILE *file)
+// Format from the extension, or from how the file starts
+{
+	char *dot = strrchr(filename, '.');
+	int c1, c2;
+
+	if (dot != NULL && strchr(dot, '/') == NULL)
+	{
+		if (strcmp(dot, ".hex") == 0 || strcmp(dot, ".ihx") == 0)
+		{
+			return FMT_HEX;
+		}
+		if (strcmp(dot, ".s19") == 0 || strcmp(dot, ".s28") == 0 ||
+				strcmp(dot, ".s37") == 0 || strcmp(dot, ".srec") == 0 ||
+				strcmp(dot, ".mot") == 0)
+		{
+			return FMT_SREC;
+		}
+		if (strcmp(dot, ".prg") == 0)
+		{
+			return FMT_PRG;
+		}
+		if (strcmp(dot, ".seg") == 0)
+		{
+			return FMT_SEG;
+		}
+	}
+
+	c1 = fgetc(file);
+	c2 = fgetc(file);
+	rewind(file);
+	if (c1 == ':' && isxdigit(c2))
+	{
+		return FMT_HEX;
+	}
+	if (c1 == 'S' && isdigit(c2))
+	{
+		return FMT_SREC;
+	}
+
+	return FMT_RAW;
+}
+
+static int load_file(loader *ld, char *filename, long addr, int depth)
+// addr is only used for raw binaries, -1 if none was given
+{
+	FILE *file;
+	int fmt, rc;
+
+	if (depth > MAX_DEPTH)
+	{
+		return -4;
+	}
+
+	file = fopen(filename, "rb");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	ld->line = 0;
+	fmt = image_format(filename, file);
+	switch (fmt)
+	{
+		case FMT_HEX:
+			rc = load_hex(ld, file);
+			break;
+		case FMT_SREC:
+			rc = load_srec(ld, file);
+			break;
+		case FMT_PRG:
+			rc = load_binary(ld, file, -1);
+			break;
+		case FMT_SEG:
+			rc = load_manifest(ld, file, filename, depth);
+			break;
+		default:
+			// A raw binary needs an address from a manifest
+			rc = (addr < 0) ? -4 : load_binary(ld, file, addr);
+			break;
+	}
+
+	fclose(file);
+	return rc;
+}
+
+int load_image(char *filename, membus *bus, load_info *info)
+// Load an image of any known format
+{
+	loader ld;
+	label *l;
+	int rc;
+
+	info->segments = 0;
+	info->bytes = 0;
+	info->entry = -1;
+	info->file[0] = '\0';
+	info->line = 0;
+
+	ld.bus = bus;
+	ld.info = info;
+	ld.next_addr = -1;
+	ld.labels = NULL;
+	ld.line = 0;
+
+	rc = load_file(&ld, filename, -1, 0);
+	if (rc < 0 && info->file[0] == '\0')
+	{
+		snprintf(info->file, sizeof(info->file), "%s", filename);
+		info->line = ld.line;
+	}
+
+	while ((l = ld.labels) != NULL)
+	{
+		ld.labels = l->next;
+		free(l);
+	}
+
+	return rc;
+}
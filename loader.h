@@ -0,0 +1,51 @@
+// loader.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Image loader for Intel HEX, S-record, PRG and segment manifests
+//
+// Brian K. Niece
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "membus.h"
+
+// What a load put in memory
+typedef struct load_info
+{
+	int segments;			// runs of consecutive bytes
+	long bytes;
+	int entry;				// start address from the image, -1 if none
+
+	// Where an error was found
+	char file[256];
+	int line;				// 0 if not in a text file
+} load_info;
+
+// Load an image in one pass, with the format from the file name
+// 	.hex .ihx			Intel HEX
+// 	.s19 .s28 .s37 .srec .mot	Motorola S-record
+// 	.prg				C64 style, a 2 byte load address then the data
+// 	.seg				manifest, a list of segments to load
+// 	Other names are read as HEX or S-record if they start like one.
+// 	Bytes are stored the way the CPU would see them, without devices or
+// 	protection.
+//
+// A manifest has a segment per line, the file and the address for a raw
+// 	binary, or just the file for the formats above.  Paths are from the
+// 	manifest's directory.  "entry addr" gives the start address, and
+// 	"labels file" reads an xa label file (xa -l) so addresses can be
+// 	labels.  Addresses are hex, # starts a comment.
+//
+// 	labels prog.lab
+// 	code.bin	0600
+// 	tables.hex
+// 	entry start
+int load_image(char *filename, membus *bus, load_info *info);
+	// returns 0 on success
+	// 		-1 on file open error
+	// 		-2 on a format or checksum error
+	// 		-3 if a segment runs past the top of memory
+	// 		-4 on an unknown format or label
+
+#endif
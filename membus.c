@@ -7,58 +7,270 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "membus.h"
+#include "arena.h"
 
-byte read(membus bus, word addr)
-// If addr is in a write only block, return 0.
-// 	An actual processor probably returns something random that
-// 	that was previously on the bus, but we don't have a record of that.
-{
-	memory_block *list;
-	list = bus.wo_blocks;
+// Files are mapped with mmap where there is one
+// 	Not unistd.h, its read() and write() would clash with the bus
+#if !defined(_WIN32)
+#define MEMBUS_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
+static int in_block(memory_block *list, word addr)
+// Check whether addr falls in any block of list
+{
 	while (list != NULL)
 	{
 		if ((addr >= list->begin) && (addr <= list->end))
 		{
-			return 0;
+			return 1;
 		}
 		list = list->next;
 	}
 
-	return bus.mem[addr];
+	return 0;
 }
 
-void write(membus bus, word addr, byte data)
-// If addr is in a read only block, return with out writing
+static mmio_device *find_device(mmio_device *list, word addr)
+// Latest device added that covers addr, or NULL
 {
-	memory_block *list;
-	list = bus.ro_blocks;
-
 	while (list != NULL)
 	{
 		if ((addr >= list->begin) && (addr <= list->end))
 		{
-			return;
+			return list;
 		}
 		list = list->next;
 	}
 
-	bus.mem[addr] = data;
+	return NULL;
+}
+
+byte read_slow(membus *bus, word addr)
+// If addr is in a write only block, return 0.
+// 	An actual processor probably returns something random that
+// 	that was previously on the bus, but we don't have a record of that.
+// Devices answer for their own addresses.
+{
+	mem_page *page = &bus->pages[addr >> 8];
+	mmio_device *device;
+
+	if (((page->attr & PG_WATCH) != 0) && (bus->watch != NULL))
+	{
+		bus->watch(bus->watch_ctx, addr, 0);
+	}
+
+	if ((page->attr & PG_WO) != 0)
+	{
+		return 0;
+	}
+	if (((page->attr & PG_WO_PART) != 0) && in_block(bus->wo_blocks, addr))
+	{
+		return 0;
+	}
+	if ((page->attr & PG_MMIO) != 0)
+	{
+		device = find_device(bus->devices, addr);
+		if ((device != NULL) && (device->on_read != NULL))
+		{
+			return device->on_read(device->dev, addr);
+		}
+	}
+
+	return page->host[addr & 0xFF];
+}
+
+void write_slow(membus *bus, word addr, byte data)
+// If addr is in a read only block, return with out writing
+// Devices take writes to their own addresses instead of memory.
+{
+	mem_page *page = &bus->pages[addr >> 8];
+	mmio_device *device = NULL;
+
+	if ((page->attr & PG_RO) != 0)
+	{
+		return;
+	}
+	if (((page->attr & PG_RO_PART) != 0) && in_block(bus->ro_blocks, addr))
+	{
+		return;
+	}
+
+	// First write since clear_dirty, later ones can stay on the fast path
+	// 	After the checks above, a dropped write leaves the page clean
+	if ((page->attr & PG_CLEAN) != 0)
+	{
+		page->attr &= ~PG_CLEAN;
+		bus->dirty[addr >> 8] = 1;
+	}
+
+	if ((page->attr & PG_MMIO) != 0)
+	{
+		device = find_device(bus->devices, addr);
+	}
+	if ((device != NULL) && (device->on_write != NULL))
+	{
+		device->on_write(device->dev, addr, data);
+	}
+	else
+	{
+		page->host[addr & 0xFF] = data;
+	}
+
+	// Let the engine know its translated code may have changed
+	if (((page->attr & PG_CODE) != 0) && (bus->code_write != NULL))
+	{
+		bus->code_write(bus->code_ctx, addr, 1);
+	}
+
+	if (((page->attr & PG_WATCH) != 0) && (bus->watch != NULL))
+	{
+		bus->watch(bus->watch_ctx, addr, 1);
+	}
+}
+
+static byte *alloc_ram(void)
+// Cleared RAM for a bus
+// 	Mapped where it can be, so the host only backs the parts that are
+// 	written.  Pages pointed at shared pages never touch theirs.
+{
+#ifdef MEMBUS_MMAP
+	byte *mem = mmap(NULL, MAX_MEM, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return (mem == MAP_FAILED) ? NULL : mem;
+#else
+	return calloc(MAX_MEM, 1);
+#endif
+}
+
+static void *bus_alloc(membus *bus, size_t size)
+// Room for a block or device record, from the bus's arena if it has one
+{
+	if (bus->arena != NULL)
+	{
+		return arena_alloc(bus->arena, size, sizeof(void *));
+	}
+	return malloc(size);
+}
+
+static void free_list(memory_block *list)
+{
+	while (list != NULL)
+	{
+		memory_block *next = list->next;
+		free(list);
+		list = next;
+	}
 }
 
 void initialize_bus(membus *bus)
 {
-	bus->mem = malloc(MAX_MEM);
+	initialize_bus_in(bus, NULL);
+}
+
+void initialize_bus_in(membus *bus, struct arena *a)
+{
+	// RAM is aligned to host pages so the host only backs what's used
+	if (a != NULL)
+	{
+		bus->mem = arena_alloc(a, MAX_MEM, 4096);
+	}
+	else
+	{
+		bus->mem = alloc_ram();
+	}
+	bus->arena = a;
 	bus->ro_blocks = NULL;
 	bus->wo_blocks = NULL;
+	bus->devices = NULL;
+	bus->store = NULL;
+	bus->store_size = 0;
+	bus->maps = NULL;
+	bus->code_write = NULL;
+	bus->code_ctx = NULL;
+	bus->watch = NULL;
+	bus->watch_ctx = NULL;
+
+	// Map every page straight to RAM
+	for (int i = 0; i < NUM_PAGES; i++)
+	{
+		bus->pages[i].host = &bus->mem[i * PAGE_SIZE];
+		bus->pages[i].attr = 0;
+		bus->dirty[i] = 0;
+	}
 }
 
-void add_block(memory_block **blocks, word begin_addr, word end_addr)
-// Add ro or wo memory block to list
+membus *new_bus(struct arena *a)
 {
-	memory_block *new_block = malloc(sizeof(memory_block));
+	membus *bus = arena_alloc(a, sizeof(membus), 64);
+	if (bus != NULL)
+	{
+		initialize_bus_in(bus, a);
+	}
+	return bus;
+}
+
+static byte bank_read(void *dev, word addr);
+
+void free_bus(membus *bus)
+{
+	unmap_images(bus);
+	free(bus->store);
+
+	// An arena frees the rest all at once
+	if (bus->arena == NULL)
+	{
+		free_list(bus->ro_blocks);
+		free_list(bus->wo_blocks);
+		while (bus->devices != NULL)
+		{
+			mmio_device *next = bus->devices->next;
+
+			// Bank registers are the bus's own, other devices the caller's
+			if (bus->devices->on_read == bank_read)
+			{
+				free(bus->devices->dev);
+			}
+			free(bus->devices);
+			bus->devices = next;
+		}
+#ifdef MEMBUS_MMAP
+		munmap(bus->mem, MAX_MEM);
+#else
+		free(bus->mem);
+#endif
+	}
+
+	bus->ro_blocks = NULL;
+	bus->wo_blocks = NULL;
+	bus->devices = NULL;
+	bus->store = NULL;
+	bus->store_size = 0;
+	bus->mem = NULL;
+}
+
+void add_block(membus *bus, int type, word begin_addr, word end_addr)
+// Add ro or wo memory block to list and mark the pages it touches
+{
+	memory_block **blocks;
+	int part;
+
+	if (type == PG_RO)
+	{
+		blocks = &bus->ro_blocks;
+		part = PG_RO_PART;
+	}
+	else
+	{
+		blocks = &bus->wo_blocks;
+		part = PG_WO_PART;
+	}
+
+	memory_block *new_block = bus_alloc(bus, sizeof(memory_block));
 	new_block->begin = begin_addr;
 	new_block->end = end_addr;
 	new_block->next = NULL;
@@ -67,6 +279,310 @@ void add_block(memory_block **blocks, word begin_addr, word end_addr)
 	// 	Order doesn't matter, and this is easy.
 	new_block->next = *blocks;
 	*blocks = new_block;
+
+	// Pages covered completely don't need the list, the rest do
+	for (int pg = begin_addr >> 8; pg <= end_addr >> 8; pg++)
+	{
+		int first = pg * PAGE_SIZE;
+		int last = first + PAGE_SIZE - 1;
+
+		if ((begin_addr <= first) && (end_addr >= last))
+		{
+			bus->pages[pg].attr |= type;
+		}
+		else
+		{
+			bus->pages[pg].attr |= part;
+		}
+	}
+}
+
+void add_device(membus *bus, word begin_addr, word end_addr,
+		mmio_read on_read, mmio_write on_write, void *dev)
+// Attach device handlers to begin_addr through end_addr and mark the pages
+// 	A device added later takes over any addresses it shares with an
+// 	earlier one.
+{
+	mmio_device *new_device = bus_alloc(bus, sizeof(mmio_device));
+	new_device->begin = begin_addr;
+	new_device->end = end_addr;
+	new_device->on_read = on_read;
+	new_device->on_write = on_write;
+	new_device->dev = dev;
+
+	// Insert new device at beginning of list
+	new_device->next = bus->devices;
+	bus->devices = new_device;
+
+	for (int pg = begin_addr >> 8; pg <= end_addr >> 8; pg++)
+	{
+		bus->pages[pg].attr |= PG_MMIO;
+	}
+}
+
+// Bank register, a device that maps the window when it's written
+typedef struct bank_register
+{
+	membus *bus;
+	word reg_addr;
+	word window;		// first address of the window
+	int npages;			// window size in pages
+	word bank;			// bank showing in the window
+} bank_register;
+
+static void remap_page(membus *bus, int pg, byte *host)
+// Point page pg at host and let an engine drop code it built from the page
+{
+	bus->pages[pg].host = host;
+	if (bus->code_write != NULL)
+	{
+		bus->code_write(bus->code_ctx, pg * PAGE_SIZE, PAGE_SIZE);
+	}
+}
+
+void clear_dirty(membus *bus)
+{
+	for (int pg = 0; pg < NUM_PAGES; pg++)
+	{
+		bus->pages[pg].attr |= PG_CLEAN;
+		bus->dirty[pg] = 0;
+	}
+}
+
+int next_dirty(membus *bus, int pg)
+{
+	for (; pg < NUM_PAGES; pg++)
+	{
+		if (bus->dirty[pg] != 0)
+		{
+			return pg;
+		}
+	}
+
+	return -1;
+}
+
+int count_dirty(membus *bus, word addr, int npages)
+{
+	int first = addr >> 8;
+	int count = 0;
+
+	for (int pg = first; (pg < first + npages) && (pg < NUM_PAGES); pg++)
+	{
+		count += bus->dirty[pg];
+	}
+
+	return count;
+}
+
+void save_mem(membus *bus, mem_snapshot *snap)
+{
+	for (int pg = 0; pg < NUM_PAGES; pg++)
+	{
+		snap->host[pg] = bus->pages[pg].host;
+		memcpy(&snap->data[pg * PAGE_SIZE], bus->pages[pg].host, PAGE_SIZE);
+	}
+
+	clear_dirty(bus);
+}
+
+void restore_mem(membus *bus, mem_snapshot *snap)
+// Put back the dirty pages
+// 	A page banked somewhere else since is pointed back first.  Pages
+// 	only banked, not written, still show what they did at the snapshot.
+// 	Read only pages are never copied to, they may be a read only mapping
+// 	or shared with other buses.
+{
+	for (int pg = 0; pg < NUM_PAGES; pg++)
+	{
+		if (bus->pages[pg].host != snap->host[pg])
+		{
+			remap_page(bus, pg, snap->host[pg]);
+		}
+		if (bus->dirty[pg] == 0)
+		{
+			continue;
+		}
+
+		bus->pages[pg].attr |= PG_CLEAN;
+		bus->dirty[pg] = 0;
+		if ((bus->pages[pg].attr & PG_RO) != 0)
+		{
+			continue;
+		}
+		memcpy(bus->pages[pg].host, &snap->data[pg * PAGE_SIZE], PAGE_SIZE);
+
+		if (((bus->pages[pg].attr & PG_CODE) != 0) &&
+				(bus->code_write != NULL))
+		{
+			bus->code_write(bus->code_ctx, pg * PAGE_SIZE, PAGE_SIZE);
+		}
+	}
+}
+
+int load_shared(char *filename, word addr, shared_pages *shared)
+// Read a file into whole pages that buses can share
+{
+	long filebytes;
+	size_t readbytes;
+
+	// Open file
+	FILE *file = fopen(filename, "rb");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	// Get file size
+	fseek(file, 0, SEEK_END);
+	filebytes = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (((addr & 0xFF) != 0) || (filebytes <= 0) ||
+			(filebytes > MAX_MEM - addr))
+	{
+		fclose(file);
+		return -3;
+	}
+
+	// The rest of the last page reads as 0
+	shared->addr = addr;
+	shared->npages = (filebytes + PAGE_SIZE - 1) / PAGE_SIZE;
+	shared->data = calloc(shared->npages, PAGE_SIZE);
+
+	readbytes = fread(shared->data, sizeof(byte), filebytes, file);
+	fclose(file);
+	if (readbytes != (size_t)filebytes)
+	{
+		free_shared(shared);
+		return -2;
+	}
+
+	return 0;
+}
+
+void share_pages(membus *bus, shared_pages *shared)
+{
+	int first = shared->addr >> 8;
+
+	for (int i = 0; i < shared->npages; i++)
+	{
+		remap_page(bus, first + i, shared->data + i * PAGE_SIZE);
+		bus->pages[first + i].attr |= PG_RO;
+	}
+}
+
+void free_shared(shared_pages *shared)
+{
+	free(shared->data);
+	shared->data = NULL;
+	shared->npages = 0;
+}
+
+int set_store(membus *bus, unsigned long size)
+// Allocate a cleared bank store of size bytes
+// 	Pages mapped into an earlier store go back to RAM.
+{
+	byte *store = calloc(size, 1);
+	if (store == NULL)
+	{
+		return -1;
+	}
+
+	for (int pg = 0; pg < NUM_PAGES; pg++)
+	{
+		byte *host = bus->pages[pg].host;
+		if ((bus->store != NULL) && (host >= bus->store) &&
+				(host < bus->store + bus->store_size))
+		{
+			remap_page(bus, pg, &bus->mem[pg * PAGE_SIZE]);
+		}
+	}
+
+	free(bus->store);
+	bus->store = store;
+	bus->store_size = size;
+
+	return 0;
+}
+
+int map_bank(membus *bus, word addr, int npages, unsigned long offset)
+{
+	int first = addr >> 8;
+
+	if ((npages < 1) || (first + npages > NUM_PAGES) ||
+			(offset > bus->store_size) ||
+			(bus->store_size - offset < (unsigned long)npages * PAGE_SIZE))
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < npages; i++)
+	{
+		remap_page(bus, first + i, bus->store + offset + i * PAGE_SIZE);
+	}
+
+	return 0;
+}
+
+static byte bank_read(void *dev, word addr)
+{
+	bank_register *reg = dev;
+
+	return (addr == reg->reg_addr) ? (reg->bank & 0xFF) : (reg->bank >> 8);
+}
+
+static void bank_write(void *dev, word addr, byte data)
+// Change one byte of the bank number and map the new bank
+// 	With a store too small for a bank since, the window stays as it is
+{
+	bank_register *reg = dev;
+	unsigned long bank_size = (unsigned long)reg->npages * PAGE_SIZE;
+	unsigned long banks = reg->bus->store_size / bank_size;
+
+	if (addr == reg->reg_addr)
+	{
+		reg->bank = (reg->bank & 0xFF00) | data;
+	}
+	else
+	{
+		reg->bank = (reg->bank & 0x00FF) | (data << 8);
+	}
+
+	if (banks == 0)
+	{
+		return;
+	}
+	map_bank(reg->bus, reg->window, reg->npages,
+		(reg->bank % banks) * bank_size);
+}
+
+int add_bank_register(membus *bus, word reg_addr, word window, int npages)
+{
+	bank_register *reg;
+
+	if ((bus->store == NULL) || (npages < 1) ||
+			((unsigned long)npages * PAGE_SIZE > bus->store_size) ||
+			((window >> 8) + npages > NUM_PAGES))
+	{
+		return -1;
+	}
+
+	reg = bus_alloc(bus, sizeof(bank_register));
+	if (reg == NULL)
+	{
+		return -2;
+	}
+	reg->bus = bus;
+	reg->reg_addr = reg_addr;
+	reg->window = window;
+	reg->npages = npages;
+	reg->bank = 0;
+
+	add_device(bus, reg_addr, reg_addr + 1, bank_read, bank_write, reg);
+	map_bank(bus, window, npages, 0);
+
+	return 0;
 }
 
 int import_mem(char *filename, membus *bus, word addr)
@@ -87,23 +603,92 @@ int import_mem(char *filename, membus *bus, word addr)
 	filebytes = ftell(file);
 	fseek(file, 0, SEEK_SET);
 
+	if (filebytes > MAX_MEM - addr)
+	{
+		fclose(file);
+		return -3;
+	}
+
 	// Read data into addr
 	readbytes = fread(&bus->mem[addr], sizeof(byte), filebytes, file);
+	fclose(file);
 	if (readbytes != filebytes)
 	{
 		return -2;
 	}
 
+	return 0;
+}
+
+int import_store(char *filename, membus *bus, unsigned long offset)
+// Read contents of binary file into the bank store at offset
+{
+	long filebytes;
+	unsigned long readbytes;
+
+	// Open file
+	FILE *file = fopen(filename, "rb");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	// Get file size
+	fseek(file, 0, SEEK_END);
+	filebytes = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if ((filebytes < 0) || (offset > bus->store_size) ||
+			((unsigned long)filebytes > bus->store_size - offset))
+	{
+		fclose(file);
+		return -3;
+	}
+
+	// Read data into the store
+	readbytes = fread(&bus->store[offset], sizeof(byte), filebytes, file);
 	fclose(file);
+	if (readbytes != (unsigned long)filebytes)
+	{
+		return -2;
+	}
 
 	return 0;
 }
 
-int export_mem(char *filename, membus *bus, word addr, int npages)
+static int export_dirty(FILE *file, membus *bus, word addr, int npages)
+// Write a record for each dirty page in the npages pages from addr
+{
+	int first = addr >> 8;
+	byte head[2];
+
+	for (int pg = first; (pg < first + npages) && (pg < NUM_PAGES); pg++)
+	{
+		if (bus->dirty[pg] == 0)
+		{
+			continue;
+		}
+
+		head[0] = 0;
+		head[1] = pg;
+		if ((fwrite(head, sizeof(byte), 2, file) != 2) ||
+				(fwrite(bus->pages[pg].host, sizeof(byte), PAGE_SIZE, file) !=
+				 PAGE_SIZE))
+		{
+			return -2;
+		}
+	}
+
+	return 0;
+}
+
+int export_mem(char *filename, membus *bus, word addr, int npages, int mode)
 // Write npages of data at specified addres to binary file
 // 	This is an emulator function, so it doesn't need to go through the CPU
+// 	Banked pages are written as they are mapped now.
 {
 	int writebytes;
+	byte *data;
 
 	// Open file
 	FILE *file = fopen(filename, "wb");
@@ -112,15 +697,273 @@ int export_mem(char *filename, membus *bus, word addr, int npages)
 		return -1;
 	}
 
+	if (mode == EXPORT_DIRTY)
+	{
+		if ((export_dirty(file, bus, addr, npages) != 0) || (fclose(file) != 0))
+		{
+			return -2;
+		}
+		return 0;
+	}
+
+	// Gather the pages, which may not be next to each other in the host
+	data = malloc(npages * 256);
+	for (int i = 0; i < npages * 256; i++)
+	{
+		data[i] = peek(bus, addr + i);
+	}
+
 	// Write data to file
-	writebytes = fwrite(&bus->mem[addr], sizeof(byte), npages * 256, file);
-	if (writebytes != npages * 256)
+	writebytes = fwrite(data, sizeof(byte), npages * 256, file);
+	free(data);
+	if ((fclose(file) != 0) || (writebytes != npages * 256))
 	{
 		return -2;
 	}
 
+	return 0;
+}
+
+static void load_page(membus *bus, int pg, byte *data)
+// Store a page's worth of data in page pg, as writes would leave it
+// 	Read only bytes are left alone, so read only mappings and shared
+// 	pages are never written.  Devices don't see the data.
+{
+	mem_page *page = &bus->pages[pg];
+	int written = 0;
+
+	if ((page->attr & PG_RO) != 0)
+	{
+		return;
+	}
+
+	for (int i = 0; i < PAGE_SIZE; i++)
+	{
+		if (((page->attr & PG_RO_PART) != 0) &&
+				in_block(bus->ro_blocks, pg * PAGE_SIZE + i))
+		{
+			continue;
+		}
+		page->host[i] = data[i];
+		written = 1;
+	}
+	if (written == 0)
+	{
+		return;
+	}
+
+	if ((page->attr & PG_CLEAN) != 0)
+	{
+		page->attr &= ~PG_CLEAN;
+		bus->dirty[pg] = 1;
+	}
+	if (((page->attr & PG_CODE) != 0) && (bus->code_write != NULL))
+	{
+		bus->code_write(bus->code_ctx, pg * PAGE_SIZE, PAGE_SIZE);
+	}
+}
+
+int import_sparse(char *filename, membus *bus)
+// Read the records of a sparse image into the pages they came from
+{
+	byte head[2];
+	byte data[PAGE_SIZE];
+	size_t readbytes;
+
+	// Open file
+	FILE *file = fopen(filename, "rb");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	while ((readbytes = fread(head, sizeof(byte), 2, file)) == 2)
+	{
+		if (head[0] != 0)
+		{
+			fclose(file);
+			return -3;
+		}
+		readbytes = fread(data, sizeof(byte), PAGE_SIZE, file);
+		if (readbytes != PAGE_SIZE)
+		{
+			fclose(file);
+			return -2;
+		}
+		load_page(bus, head[1], data);
+	}
+
 	fclose(file);
+	if (readbytes != 0)
+	{
+		return -2;
+	}
 
 	return 0;
 }
 
+#ifdef MEMBUS_MMAP
+static void add_mapping(membus *bus, byte *base, unsigned long len, word addr,
+		int npages)
+// Point npages pages from addr at base and remember the mapping
+{
+	mapped_file *map = malloc(sizeof(mapped_file));
+	int first = addr >> 8;
+
+	map->base = base;
+	map->len = len;
+	map->first = first;
+	map->npages = npages;
+	map->attr = malloc(npages);
+	for (int i = 0; i < npages; i++)
+	{
+		map->attr[i] = bus->pages[first + i].attr;
+		remap_page(bus, first + i, base + i * PAGE_SIZE);
+	}
+
+	map->next = bus->maps;
+	bus->maps = map;
+}
+
+int map_image(char *filename, membus *bus, word addr, int mode)
+{
+	struct stat st;
+	unsigned long len;
+	int npages;
+	byte *base;
+
+	FILE *file = fopen(filename, "rb");
+	if (file == NULL)
+	{
+		return -1;
+	}
+	if (fstat(fileno(file), &st) != 0)
+	{
+		fclose(file);
+		return -2;
+	}
+
+	// Whole pages, the rest of the last one reads as 0
+	npages = (st.st_size + PAGE_SIZE - 1) / PAGE_SIZE;
+	len = (unsigned long)npages * PAGE_SIZE;
+	if (((addr & 0xFF) != 0) || (npages == 0) ||
+			((addr >> 8) + npages > NUM_PAGES))
+	{
+		fclose(file);
+		return -3;
+	}
+
+	if (mode == MAP_READ_ONLY)
+	{
+		base = mmap(NULL, len, PROT_READ, MAP_SHARED, fileno(file), 0);
+	}
+	else
+	{
+		base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+			fileno(file), 0);
+	}
+	fclose(file);
+	if (base == MAP_FAILED)
+	{
+		return -2;
+	}
+
+	add_mapping(bus, base, len, addr, npages);
+	if (mode == MAP_READ_ONLY)
+	{
+		for (int i = 0; i < npages; i++)
+		{
+			bus->pages[(addr >> 8) + i].attr |= PG_RO;
+		}
+	}
+
+	return 0;
+}
+
+int map_output(char *filename, membus *bus, word addr, int npages)
+{
+	unsigned long len = (unsigned long)npages * PAGE_SIZE;
+	byte *base;
+
+	if (((addr & 0xFF) != 0) || (npages < 1) ||
+			((addr >> 8) + npages > NUM_PAGES))
+	{
+		return -3;
+	}
+
+	FILE *file = fopen(filename, "w+b");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	// Size the file by writing its last byte
+	if ((fseek(file, len - 1, SEEK_SET) != 0) || (fputc(0, file) == EOF) ||
+			(fflush(file) != 0))
+	{
+		fclose(file);
+		return -2;
+	}
+
+	base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), 0);
+	fclose(file);
+	if (base == MAP_FAILED)
+	{
+		return -2;
+	}
+
+	// Start the file with what the pages hold now
+	for (unsigned long i = 0; i < len; i++)
+	{
+		base[i] = peek(bus, addr + i);
+	}
+
+	add_mapping(bus, base, len, addr, npages);
+
+	return 0;
+}
+
+void unmap_images(membus *bus)
+{
+	while (bus->maps != NULL)
+	{
+		mapped_file *map = bus->maps;
+
+		// Pages still showing the file keep what they hold, in RAM
+		for (int i = 0; i < map->npages; i++)
+		{
+			int pg = map->first + i;
+			if (bus->pages[pg].host == map->base + i * PAGE_SIZE)
+			{
+				memcpy(&bus->mem[pg * PAGE_SIZE], bus->pages[pg].host,
+					PAGE_SIZE);
+				// Only undo the PG_RO a read only image added, any marks
+				// 	made since stay
+				bus->pages[pg].attr = (bus->pages[pg].attr & ~PG_RO) |
+					(map->attr[i] & PG_RO);
+				remap_page(bus, pg, &bus->mem[pg * PAGE_SIZE]);
+			}
+		}
+
+		munmap(map->base, map->len);
+		bus->maps = map->next;
+		free(map->attr);
+		free(map);
+	}
+}
+#else
+int map_image(char *filename, membus *bus, word addr, int mode)
+{
+	return -4;
+}
+
+int map_output(char *filename, membus *bus, word addr, int npages)
+{
+	return -4;
+}
+
+void unmap_images(membus *bus)
+{
+}
+#endif
+
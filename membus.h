@@ -10,9 +10,29 @@
 
 // Definitions for emulator constants
 #define MAX_MEM 64*1024
+#define PAGE_SIZE 256
+#define NUM_PAGES (MAX_MEM / PAGE_SIZE)
+
+// Page attribute bits
+#define PG_RO		0x01	// whole page is read only
+#define PG_WO		0x02	// whole page is write only
+#define PG_RO_PART	0x04	// some of the page is read only, check ro_blocks
+#define PG_WO_PART	0x08	// some of the page is write only, check wo_blocks
+#define PG_MMIO		0x10	// memory mapped I/O
+#define PG_WATCH	0x20	// watched
+#define PG_CODE		0x40	// an engine has translated code from the page
+#define PG_CLEAN	0x80	// not written since clear_dirty, see dirty
+
+// Pages with any of these bits set go through the slow path
+#define PG_READ_SLOW	(PG_WO | PG_WO_PART | PG_MMIO | PG_WATCH)
+#define PG_WRITE_SLOW	(PG_RO | PG_RO_PART | PG_MMIO | PG_WATCH | PG_CODE | \
+		PG_CLEAN)
 
 // Type definitions
 typedef unsigned char byte;
+
+// Arena the bus allocates from, see arena.h
+struct arena;
 typedef unsigned short word;
 
 typedef struct memory_block
@@ -22,30 +42,295 @@ typedef struct memory_block
 	struct memory_block *next;
 } memory_block;
 
+// Memory mapped device handlers
+// 	dev is the pointer given to add_device
+typedef byte (*mmio_read)(void *dev, word addr);
+typedef void (*mmio_write)(void *dev, word addr, byte data);
+
+typedef struct mmio_device
+{
+	word begin;
+	word end;
+	mmio_read on_read;		// NULL to read memory instead
+	mmio_write on_write;		// NULL to write memory instead
+	void *dev;
+	struct mmio_device *next;
+} mmio_device;
+
+// A file mapped into the address space by map_image or map_output
+typedef struct mapped_file
+{
+	byte *base;				// start of the mapping
+	unsigned long len;	// bytes mapped
+	int first;				// first page it shows in
+	int npages;
+	byte *attr;				// page attributes from before the mapping
+	struct mapped_file *next;
+} mapped_file;
+
+typedef struct mem_page
+{
+	byte *host;		// Where the page lives in emulator memory
+	byte attr;		// PG_ attribute bits
+} mem_page;
+
 typedef struct membus
 {
 	byte *mem;
+	struct arena *arena;		// NULL when allocated from the heap
+	mem_page pages[NUM_PAGES];
+
+	// Bank store, mapped into the address space a window at a time
+	byte *store;
+	unsigned long store_size;
+
+	// Files mapped straight into pages
+	mapped_file *maps;
+
+	// 1 for each page written since clear_dirty
+	// 	Only the first write to a PG_CLEAN page takes the slow path, it
+	// 	sets the page's dirty byte and clears PG_CLEAN.
+	byte dirty[NUM_PAGES];
+
 	memory_block *ro_blocks;
 	memory_block *wo_blocks;
+	mmio_device *devices;
+
+	// Called after a write to a PG_CODE page (len 1), and for every page
+	// 	map_bank points somewhere new (addr at the page, len PAGE_SIZE)
+	void (*code_write)(void *code_ctx, word addr, int len);
+	void *code_ctx;
+
+	// Called on every read (write = 0) and write (write = 1) of a
+	// 	PG_WATCH page
+	void (*watch)(void *watch_ctx, word addr, int write);
+	void *watch_ctx;
 } membus;
 
 // Bus actions
-byte read(membus bus, word addr);
-void write(membus bus, word addr, byte data);
+// 	Plain RAM is read or written straight through the page table.  Anything
+// 	else goes to the slow path, which knows about the block lists.
+byte read_slow(membus *bus, word addr);
+void write_slow(membus *bus, word addr, byte data);
+
+static inline byte read(membus *bus, word addr)
+{
+	mem_page *page = &bus->pages[addr >> 8];
+
+	if ((page->attr & PG_READ_SLOW) == 0)
+	{
+		return page->host[addr & 0xFF];
+	}
+	return read_slow(bus, addr);
+}
+
+static inline void write(membus *bus, word addr, byte data)
+{
+	mem_page *page = &bus->pages[addr >> 8];
+
+	if ((page->attr & PG_WRITE_SLOW) == 0)
+	{
+		page->host[addr & 0xFF] = data;
+		return;
+	}
+	write_slow(bus, addr, data);
+}
+
+// Zero page and stack
+// 	The page is known, so there is no address to split.  Plain RAM goes
+// 	straight to host memory, the same as read and write.
+static inline byte read_zp(membus *bus, byte addr)
+{
+	mem_page *page = &bus->pages[0];
+
+	if ((page->attr & PG_READ_SLOW) == 0)
+	{
+		return page->host[addr];
+	}
+	return read_slow(bus, addr);
+}
+
+static inline void write_zp(membus *bus, byte addr, byte data)
+{
+	mem_page *page = &bus->pages[0];
+
+	if ((page->attr & PG_WRITE_SLOW) == 0)
+	{
+		page->host[addr] = data;
+		return;
+	}
+	write_slow(bus, addr, data);
+}
+
+static inline byte read_stack(membus *bus, byte sp)
+{
+	mem_page *page = &bus->pages[1];
+
+	if ((page->attr & PG_READ_SLOW) == 0)
+	{
+		return page->host[sp];
+	}
+	return read_slow(bus, 0x100 + sp);
+}
+
+static inline void write_stack(membus *bus, byte sp, byte data)
+{
+	mem_page *page = &bus->pages[1];
+
+	if ((page->attr & PG_WRITE_SLOW) == 0)
+	{
+		page->host[sp] = data;
+		return;
+	}
+	write_slow(bus, 0x100 + sp, data);
+}
+
+// Byte the CPU would see at addr, without devices or watch hooks
+// 	For the emulator's own use, such as printing memory
+static inline byte peek(membus *bus, word addr)
+{
+	return bus->pages[addr >> 8].host[addr & 0xFF];
+}
+
+// Store data where the CPU would read it, past devices and protection
+static inline void poke(membus *bus, word addr, byte data)
+{
+	bus->pages[addr >> 8].host[addr & 0xFF] = data;
+}
 
 // Setup Functions
 void initialize_bus(membus *bus);
-void add_block(memory_block **blocks, word begin_addr, word end_addr);
+void initialize_bus_in(membus *bus, struct arena *a);
+	// RAM, blocks and devices come from the arena
+membus *new_bus(struct arena *a);
+	// An initialized bus from the arena
+	// returns NULL if the host is out of memory
+void free_bus(membus *bus);
+	// Releases the RAM, blocks, devices, store and mapped files
+	// 	A bus from an arena only needs it for the store and mapped files,
+	// 	free_arena does the rest
+void add_block(membus *bus, int type, word begin_addr, word end_addr);
+	// type is PG_RO or PG_WO
+void add_device(membus *bus, word begin_addr, word end_addr,
+		mmio_read on_read, mmio_write on_write, void *dev);
+	// Only PG_MMIO pages look for a device, the rest stay on the fast path
+
+// Dirty pages
+// 	Which pages were written since clear_dirty (or a snapshot was saved
+// 	or restored).  Until then no page is tracked.
+void clear_dirty(membus *bus);
+	// Mark every page clean, the next write to each one marks it dirty
+int next_dirty(membus *bus, int pg);
+	// returns the first dirty page from pg on
+	// 		-1 if there are no more
+	// 	for (pg = next_dirty(bus, 0); pg >= 0; pg = next_dirty(bus, pg + 1))
+int count_dirty(membus *bus, word addr, int npages);
+	// returns the number of dirty pages in npages pages from addr
+
+// Memory snapshots
+// 	A snapshot holds what each page shows and where it points.  Restoring
+// 	copies back only the pages written since the snapshot, so it costs
+// 	about as much as the memory the program touched.  The bank store,
+// 	devices and mapped files themselves aren't saved.
+typedef struct mem_snapshot
+{
+	byte data[MAX_MEM];
+	byte *host[NUM_PAGES];
+} mem_snapshot;
+
+void save_mem(membus *bus, mem_snapshot *snap);
+	// Also clears the dirty pages
+void restore_mem(membus *bus, mem_snapshot *snap);
+	// Also clears the dirty pages, ready to restore again
+
+// Shared pages
+// 	Many buses can run one program without each loading its own copy.
+// 	The pages are read once, and each bus's page table points at them,
+// 	marked PG_RO.  RAM is only backed by the host where it is written, so
+// 	a bus costs about the pages its program writes.
+typedef struct shared_pages
+{
+	byte *data;			// npages * PAGE_SIZE bytes, never written
+	word addr;			// where the pages show on a bus
+	int npages;
+} shared_pages;
+
+int load_shared(char *filename, word addr, shared_pages *shared);
+	// returns 0 on success
+	// 		-1 on file open error
+	// 		-2 on file read error
+	// 		-3 if addr isn't on a page or the file doesn't fit above it
+void share_pages(membus *bus, shared_pages *shared);
+void free_shared(shared_pages *shared);
+	// Only once every bus sharing the pages is freed
+
+// Bank switching
+// 	The store can be much bigger than the address space.  Banking only
+// 	changes page table pointers, nothing is copied.
+int set_store(membus *bus, unsigned long size);
+	// returns 0 on success
+	// 		-1 if the store can't be allocated
+int map_bank(membus *bus, word addr, int npages, unsigned long offset);
+	// Point npages pages from addr at the store, starting offset bytes in
+	// returns 0 on success
+	// 		-1 if that runs past the store or the top of memory
+int add_bank_register(membus *bus, word reg_addr, word window, int npages);
+	// A 16 bit bank number at reg_addr (low) and reg_addr + 1 (high)
+	// 	picks which npages * PAGE_SIZE bytes of the store show in the
+	// 	window.  Bank numbers past the end of the store wrap around.
+	// 	The window starts at bank 0.
+	// returns 0 on success
+	// 		-1 if there is no store or the window doesn't fit
+	// 		-2 if the register can't be allocated
 
 // I/O functions
 int import_mem(char *filename, membus *bus, word addr);
 	// returns 0 on success
-	// 		-1 on file epen error
+	// 		-1 on file open error
+	// 		-2 on file read error
+	// 		-3 if the file doesn't fit above addr
+int import_store(char *filename, membus *bus, unsigned long offset);
+	// Same as import_mem, into the bank store
+	// returns 0 on success
+	// 		-1 on file open error
 	// 		-2 on file read error
-int export_mem(char *filename, membus *bus, word addr, int npages);
+	// 		-3 if the file doesn't fit in the store
+// Export modes
+// 	A sparse image is a record for each dirty page in the range, the
+// 	page's address (low byte first) followed by its 256 bytes
+#define EXPORT_ALL 0		// every page, as a flat image
+#define EXPORT_DIRTY 1	// only dirty pages, as a sparse image
+int export_mem(char *filename, membus *bus, word addr, int npages, int mode);
 	// returns 0 on success
-	// 		-1 on file epen error
+	// 		-1 on file open error
 	// 		-2 on file write error
+int import_sparse(char *filename, membus *bus);
+	// Read a sparse image back in at the addresses it was saved from
+	// 	Stored as writes would leave the pages, read only bytes are skipped
+	// returns 0 on success
+	// 		-1 on file open error
+	// 		-2 on file read error, or a record that isn't whole
+	// 		-3 on a record that isn't at the start of a page
+
+// Memory mapped files, in place of import_mem and export_mem
+// 	addr must be at the start of a page, since whole pages are pointed at
+// 	the file.  Pages of a read only image are marked PG_RO, so stores to
+// 	them are dropped.  A copy on write image can be changed by the
+// 	program without changing the file.
+#define MAP_READ_ONLY 0
+#define MAP_COPY_ON_WRITE 1
+int map_image(char *filename, membus *bus, word addr, int mode);
+	// returns 0 on success
+	// 		-1 on file open error
+	// 		-2 on file map error
+	// 		-3 if addr isn't on a page or the file doesn't fit above it
+	// 		-4 if this host can't map files
+int map_output(char *filename, membus *bus, word addr, int npages);
+	// The file is created with what the pages hold now, and from then on
+	// 	is the pages, so it is up to date while the program runs
+	// returns the same as map_image
+void unmap_images(membus *bus);
+	// Copy mapped pages back to RAM and release the files
 //void print_mem_page(membus *mem, word addr, int mark);
 
 #endif
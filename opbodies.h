@@ -0,0 +1,210 @@
+// opbodies.h
+//
+// Definitions for 6502 emulator program
+// 	Instruction bodies shared by the threaded and block cache engines
+//
+// Brian K. Niece
+//
+// No include guard, this is included in the middle of each engine's run
+// 	function, after it has defined OPCODE, UNDEFINED, NEXT, DISPATCH,
+// 	WR, OPR8 and OPR16.  See opcore.h for the rest.  BRK is left to the
+// 	engines since it ends the run.
+
+	// Loads
+	OPCODE(A9)	M = OPR8; DO_LOAD(A);					NEXT(2, 2);
+	OPCODE(A5)	EA_ZPG; M = RDZ(addr); DO_LOAD(A);			NEXT(2, 3);
+	OPCODE(B5)	EA_ZPX; M = RDZ(addr); DO_LOAD(A);			NEXT(2, 4);
+	OPCODE(AD)	EA_ABS; M = RD(addr); DO_LOAD(A);			NEXT(3, 4);
+	OPCODE(BD)	EA_ABX; M = RD(addr); DO_LOAD(A);			NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(B9)	EA_ABY; M = RD(addr); DO_LOAD(A);			NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(A1)	EA_XIND; M = RD(addr); DO_LOAD(A);			NEXT(2, 6);
+	OPCODE(B1)	EA_INDY; M = RD(addr); DO_LOAD(A);			NEXT(2, 5 + PAGE_CROSS);
+	OPCODE(A2)	M = OPR8; DO_LOAD(X);					NEXT(2, 2);
+	OPCODE(A6)	EA_ZPG; M = RDZ(addr); DO_LOAD(X);			NEXT(2, 3);
+	OPCODE(B6)	EA_ZPY; M = RDZ(addr); DO_LOAD(X);			NEXT(2, 4);
+	OPCODE(AE)	EA_ABS; M = RD(addr); DO_LOAD(X);			NEXT(3, 4);
+	OPCODE(BE)	EA_ABY; M = RD(addr); DO_LOAD(X);			NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(A0)	M = OPR8; DO_LOAD(Y);					NEXT(2, 2);
+	OPCODE(A4)	EA_ZPG; M = RDZ(addr); DO_LOAD(Y);			NEXT(2, 3);
+	OPCODE(B4)	EA_ZPX; M = RDZ(addr); DO_LOAD(Y);			NEXT(2, 4);
+	OPCODE(AC)	EA_ABS; M = RD(addr); DO_LOAD(Y);			NEXT(3, 4);
+	OPCODE(BC)	EA_ABX; M = RD(addr); DO_LOAD(Y);			NEXT(3, 4 + PAGE_CROSS);
+
+	// Stores
+	OPCODE(85)	EA_ZPG; WR(addr, A);							NEXT(2, 3);
+	OPCODE(95)	EA_ZPX; WR(addr, A);							NEXT(2, 4);
+	OPCODE(8D)	EA_ABS; WR(addr, A);							NEXT(3, 4);
+	OPCODE(9D)	EA_ABX; WR(addr, A);							NEXT(3, 5);
+	OPCODE(99)	EA_ABY; WR(addr, A);							NEXT(3, 5);
+	OPCODE(81)	EA_XIND; WR(addr, A);						NEXT(2, 6);
+	OPCODE(91)	EA_INDY; WR(addr, A);						NEXT(2, 6);
+	OPCODE(86)	EA_ZPG; WR(addr, X);							NEXT(2, 3);
+	OPCODE(96)	EA_ZPY; WR(addr, X);							NEXT(2, 4);
+	OPCODE(8E)	EA_ABS; WR(addr, X);							NEXT(3, 4);
+	OPCODE(84)	EA_ZPG; WR(addr, Y);							NEXT(2, 3);
+	OPCODE(94)	EA_ZPX; WR(addr, Y);							NEXT(2, 4);
+	OPCODE(8C)	EA_ABS; WR(addr, Y);							NEXT(3, 4);
+
+	// Logical
+	OPCODE(09)	M = OPR8; DO_ORA;						NEXT(2, 2);
+	OPCODE(05)	EA_ZPG; M = RDZ(addr); DO_ORA;				NEXT(2, 3);
+	OPCODE(15)	EA_ZPX; M = RDZ(addr); DO_ORA;				NEXT(2, 4);
+	OPCODE(0D)	EA_ABS; M = RD(addr); DO_ORA;				NEXT(3, 4);
+	OPCODE(1D)	EA_ABX; M = RD(addr); DO_ORA;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(19)	EA_ABY; M = RD(addr); DO_ORA;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(01)	EA_XIND; M = RD(addr); DO_ORA;				NEXT(2, 6);
+	OPCODE(11)	EA_INDY; M = RD(addr); DO_ORA;				NEXT(2, 5 + PAGE_CROSS);
+	OPCODE(29)	M = OPR8; DO_AND;						NEXT(2, 2);
+	OPCODE(25)	EA_ZPG; M = RDZ(addr); DO_AND;				NEXT(2, 3);
+	OPCODE(35)	EA_ZPX; M = RDZ(addr); DO_AND;				NEXT(2, 4);
+	OPCODE(2D)	EA_ABS; M = RD(addr); DO_AND;				NEXT(3, 4);
+	OPCODE(3D)	EA_ABX; M = RD(addr); DO_AND;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(39)	EA_ABY; M = RD(addr); DO_AND;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(21)	EA_XIND; M = RD(addr); DO_AND;				NEXT(2, 6);
+	OPCODE(31)	EA_INDY; M = RD(addr); DO_AND;				NEXT(2, 5 + PAGE_CROSS);
+	OPCODE(49)	M = OPR8; DO_EOR;						NEXT(2, 2);
+	OPCODE(45)	EA_ZPG; M = RDZ(addr); DO_EOR;				NEXT(2, 3);
+	OPCODE(55)	EA_ZPX; M = RDZ(addr); DO_EOR;				NEXT(2, 4);
+	OPCODE(4D)	EA_ABS; M = RD(addr); DO_EOR;				NEXT(3, 4);
+	OPCODE(5D)	EA_ABX; M = RD(addr); DO_EOR;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(59)	EA_ABY; M = RD(addr); DO_EOR;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(41)	EA_XIND; M = RD(addr); DO_EOR;				NEXT(2, 6);
+	OPCODE(51)	EA_INDY; M = RD(addr); DO_EOR;				NEXT(2, 5 + PAGE_CROSS);
+	OPCODE(24)	EA_ZPG; M = RDZ(addr); DO_BIT;				NEXT(2, 3);
+	OPCODE(2C)	EA_ABS; M = RD(addr); DO_BIT;				NEXT(3, 4);
+
+	// Arithmetic
+	OPCODE(69)	M = OPR8; DO_ADC;						NEXT(2, 2);
+	OPCODE(65)	EA_ZPG; M = RDZ(addr); DO_ADC;				NEXT(2, 3);
+	OPCODE(75)	EA_ZPX; M = RDZ(addr); DO_ADC;				NEXT(2, 4);
+	OPCODE(6D)	EA_ABS; M = RD(addr); DO_ADC;				NEXT(3, 4);
+	OPCODE(7D)	EA_ABX; M = RD(addr); DO_ADC;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(79)	EA_ABY; M = RD(addr); DO_ADC;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(61)	EA_XIND; M = RD(addr); DO_ADC;				NEXT(2, 6);
+	OPCODE(71)	EA_INDY; M = RD(addr); DO_ADC;				NEXT(2, 5 + PAGE_CROSS);
+	OPCODE(E9)	M = OPR8; DO_SBC;						NEXT(2, 2);
+	OPCODE(E5)	EA_ZPG; M = RDZ(addr); DO_SBC;				NEXT(2, 3);
+	OPCODE(F5)	EA_ZPX; M = RDZ(addr); DO_SBC;				NEXT(2, 4);
+	OPCODE(ED)	EA_ABS; M = RD(addr); DO_SBC;				NEXT(3, 4);
+	OPCODE(FD)	EA_ABX; M = RD(addr); DO_SBC;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(F9)	EA_ABY; M = RD(addr); DO_SBC;				NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(E1)	EA_XIND; M = RD(addr); DO_SBC;				NEXT(2, 6);
+	OPCODE(F1)	EA_INDY; M = RD(addr); DO_SBC;				NEXT(2, 5 + PAGE_CROSS);
+
+	// Compares
+	OPCODE(C9)	M = OPR8; DO_CMP(A);					NEXT(2, 2);
+	OPCODE(C5)	EA_ZPG; M = RDZ(addr); DO_CMP(A);			NEXT(2, 3);
+	OPCODE(D5)	EA_ZPX; M = RDZ(addr); DO_CMP(A);			NEXT(2, 4);
+	OPCODE(CD)	EA_ABS; M = RD(addr); DO_CMP(A);			NEXT(3, 4);
+	OPCODE(DD)	EA_ABX; M = RD(addr); DO_CMP(A);			NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(D9)	EA_ABY; M = RD(addr); DO_CMP(A);			NEXT(3, 4 + PAGE_CROSS);
+	OPCODE(C1)	EA_XIND; M = RD(addr); DO_CMP(A);			NEXT(2, 6);
+	OPCODE(D1)	EA_INDY; M = RD(addr); DO_CMP(A);			NEXT(2, 5 + PAGE_CROSS);
+	OPCODE(E0)	M = OPR8; DO_CMP(X);					NEXT(2, 2);
+	OPCODE(E4)	EA_ZPG; M = RDZ(addr); DO_CMP(X);			NEXT(2, 3);
+	OPCODE(EC)	EA_ABS; M = RD(addr); DO_CMP(X);			NEXT(3, 4);
+	OPCODE(C0)	M = OPR8; DO_CMP(Y);					NEXT(2, 2);
+	OPCODE(C4)	EA_ZPG; M = RDZ(addr); DO_CMP(Y);			NEXT(2, 3);
+	OPCODE(CC)	EA_ABS; M = RD(addr); DO_CMP(Y);			NEXT(3, 4);
+
+	// Increments and decrements
+	OPCODE(E6)	EA_ZPG; M = RDZ(addr) + 1; SET_NZ(M); WR(addr, M);	NEXT(2, 5);
+	OPCODE(F6)	EA_ZPX; M = RDZ(addr) + 1; SET_NZ(M); WR(addr, M);	NEXT(2, 6);
+	OPCODE(EE)	EA_ABS; M = RD(addr) + 1; SET_NZ(M); WR(addr, M);	NEXT(3, 6);
+	OPCODE(FE)	EA_ABX; M = RD(addr) + 1; SET_NZ(M); WR(addr, M);	NEXT(3, 7);
+	OPCODE(C6)	EA_ZPG; M = RDZ(addr) - 1; SET_NZ(M); WR(addr, M);	NEXT(2, 5);
+	OPCODE(D6)	EA_ZPX; M = RDZ(addr) - 1; SET_NZ(M); WR(addr, M);	NEXT(2, 6);
+	OPCODE(CE)	EA_ABS; M = RD(addr) - 1; SET_NZ(M); WR(addr, M);	NEXT(3, 6);
+	OPCODE(DE)	EA_ABX; M = RD(addr) - 1; SET_NZ(M); WR(addr, M);	NEXT(3, 7);
+	OPCODE(E8)	X++; SET_NZ(X);									NEXT(1, 2);
+	OPCODE(C8)	Y++; SET_NZ(Y);									NEXT(1, 2);
+	OPCODE(CA)	X--; SET_NZ(X);									NEXT(1, 2);
+	OPCODE(88)	Y--; SET_NZ(Y);									NEXT(1, 2);
+
+	// Shifts and rotates
+	OPCODE(0A)	M = A; DO_ASL; A = M;								NEXT(1, 2);
+	OPCODE(06)	EA_ZPG; M = RDZ(addr); DO_ASL; WR(addr, M);	NEXT(2, 5);
+	OPCODE(16)	EA_ZPX; M = RDZ(addr); DO_ASL; WR(addr, M);	NEXT(2, 6);
+	OPCODE(0E)	EA_ABS; M = RD(addr); DO_ASL; WR(addr, M);	NEXT(3, 6);
+	OPCODE(1E)	EA_ABX; M = RD(addr); DO_ASL; WR(addr, M);	NEXT(3, 7);
+	OPCODE(4A)	M = A; DO_LSR; A = M;								NEXT(1, 2);
+	OPCODE(46)	EA_ZPG; M = RDZ(addr); DO_LSR; WR(addr, M);	NEXT(2, 5);
+	OPCODE(56)	EA_ZPX; M = RDZ(addr); DO_LSR; WR(addr, M);	NEXT(2, 6);
+	OPCODE(4E)	EA_ABS; M = RD(addr); DO_LSR; WR(addr, M);	NEXT(3, 6);
+	OPCODE(5E)	EA_ABX; M = RD(addr); DO_LSR; WR(addr, M);	NEXT(3, 7);
+	OPCODE(2A)	M = A; DO_ROL; A = M;								NEXT(1, 2);
+	OPCODE(26)	EA_ZPG; M = RDZ(addr); DO_ROL; WR(addr, M);	NEXT(2, 5);
+	OPCODE(36)	EA_ZPX; M = RDZ(addr); DO_ROL; WR(addr, M);	NEXT(2, 6);
+	OPCODE(2E)	EA_ABS; M = RD(addr); DO_ROL; WR(addr, M);	NEXT(3, 6);
+	OPCODE(3E)	EA_ABX; M = RD(addr); DO_ROL; WR(addr, M);	NEXT(3, 7);
+	OPCODE(6A)	M = A; DO_ROR; A = M;								NEXT(1, 2);
+	OPCODE(66)	EA_ZPG; M = RDZ(addr); DO_ROR; WR(addr, M);	NEXT(2, 5);
+	OPCODE(76)	EA_ZPX; M = RDZ(addr); DO_ROR; WR(addr, M);	NEXT(2, 6);
+	OPCODE(6E)	EA_ABS; M = RD(addr); DO_ROR; WR(addr, M);	NEXT(3, 6);
+	OPCODE(7E)	EA_ABX; M = RD(addr); DO_ROR; WR(addr, M);	NEXT(3, 7);
+
+	// Transfers
+	// 	TSX and TXS leave the flags alone, as in instructions.c
+	OPCODE(AA)	X = A; SET_NZ(X);									NEXT(1, 2);
+	OPCODE(A8)	Y = A; SET_NZ(Y);									NEXT(1, 2);
+	OPCODE(8A)	A = X; SET_NZ(A);									NEXT(1, 2);
+	OPCODE(98)	A = Y; SET_NZ(A);									NEXT(1, 2);
+	OPCODE(BA)	X = SP;												NEXT(1, 2);
+	OPCODE(9A)	SP = X;												NEXT(1, 2);
+
+	// Stack
+	OPCODE(48)	PUSH(A);												NEXT(1, 3);
+	OPCODE(08)	PUSH(SR | B);										NEXT(1, 3);
+	OPCODE(68)	PULL(A); SET_NZ(A);								NEXT(1, 4);
+	OPCODE(28)	PULL(SR);											NEXT(1, 4);
+
+	// Flags
+	OPCODE(18)	SR &= ~C;											NEXT(1, 2);
+	OPCODE(38)	SR |= C;												NEXT(1, 2);
+	OPCODE(58)	SR &= ~I;											NEXT(1, 2);
+	OPCODE(78)	SR |= I;												NEXT(1, 2);
+	OPCODE(B8)	SR &= ~V;											NEXT(1, 2);
+	OPCODE(D8)	SR &= ~D;											NEXT(1, 2);
+	OPCODE(F8)	SR |= D;												NEXT(1, 2);
+
+	// Branches
+	OPCODE(10)	BRANCH((SR & N) == 0);
+	OPCODE(30)	BRANCH((SR & N) != 0);
+	OPCODE(50)	BRANCH((SR & V) == 0);
+	OPCODE(70)	BRANCH((SR & V) != 0);
+	OPCODE(90)	BRANCH((SR & C) == 0);
+	OPCODE(B0)	BRANCH((SR & C) != 0);
+	OPCODE(D0)	BRANCH((SR & Z) == 0);
+	OPCODE(F0)	BRANCH((SR & Z) != 0);
+
+	// Jumps and returns
+	OPCODE(4C)	EA_ABS; PC = addr;									NEXT(0, 3);
+	OPCODE(6C)
+		// The pointer high byte is fetched without carry into the next
+		// 	page, the same as a MOS 6502
+		EA_ABS;
+		M = RD(addr);
+		addr = M + (RD((addr & 0xFF00) | ((addr + 1) & 0xFF)) << 8);
+		PC = addr;
+		NEXT(0, 5);
+	OPCODE(20)
+		PUSH((PC + 2) >> 8);
+		PUSH((PC + 2) & 0xFF);
+		EA_ABS;
+		PC = addr;
+		NEXT(0, 6);
+	OPCODE(60)
+		PULL(M);
+		PULL(addr);
+		PC = M + (addr << 8) + 1;
+		NEXT(0, 6);
+	OPCODE(40)
+		PULL(SR);
+		PULL(M);
+		PULL(addr);
+		PC = M + (addr << 8);
+		NEXT(0, 6);
+
+	OPCODE(EA)
+	UNDEFINED
+		NEXT(1, 2);
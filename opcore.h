@@ -0,0 +1,143 @@
+// opcore.h
+//
+// Definitions for 6502 emulator program
+// 	Helpers and macros shared by the threaded and block cache engines
+//
+// Brian K. Niece
+//
+// The engines keep the registers in local variables named PC, SP, A, X,
+// 	Y and SR, with scratch variables M, zad, addr, base and r, and a
+// 	cycle counter named cycles.  The macros below work on those.
+
+#ifndef OPCORE_H
+#define OPCORE_H
+
+#include "bcd.h"
+#include "cpu.h"
+#include "membus.h"
+
+// Use computed goto (labels as values) where the compiler has it
+#if defined(__GNUC__)
+#define THREADED_GOTO
+#endif
+
+static inline void adc_decimal(byte *A, byte *SR, byte M)
+// Add with Carry in BCD mode, from the tables in bcd.c
+{
+	word r = bcd_adc_table[*SR & C][*A][M];
+
+	*A = r & 0xFF;
+	*SR = (*SR & ~(N | V | Z | C)) | (r >> 8);
+}
+
+static inline void sbc_decimal(byte *A, byte *SR, byte M)
+// Subtract with Carry in BCD mode, from the tables in bcd.c
+{
+	word r = bcd_sbc_table[*SR & C][*A][M];
+
+	*A = r & 0xFF;
+	*SR = (*SR & ~(N | V | Z | C)) | (r >> 8);
+}
+
+// Bus access
+// 	Each engine defines WR, and OPR8 and OPR16 for the operand of the
+// 	current instruction
+#define RD(a)		read(bus, (word)(a))
+#define RDZ(a)		read_zp(bus, (byte)(a))		// a is in the zero page
+
+// Flag updates, same logic as set_N, set_Z, set_C and set_V in cpu.c
+#define SET_NZ(r)	SR = (SR & ~(N | Z)) | ((r) & N) | (((r) & 0xFF) ? 0 : Z)
+#define SET_C(r)	SR = (SR & ~C) | (((r) >> 8) & C)
+#define SET_V(a, m, r)	SR = (SR & ~V) | ((((a) ^ (r)) & ((m) ^ (r)) & 0x80) ? V : 0)
+
+// Effective address for each addressing mode
+#define EA_ZPG	addr = OPR8
+#define EA_ZPX	addr = (byte)(OPR8 + X)
+#define EA_ZPY	addr = (byte)(OPR8 + Y)
+#define EA_ABS	addr = OPR16
+#define EA_ABX	base = OPR16; addr = base + X
+#define EA_ABY	base = OPR16; addr = base + Y
+#define EA_XIND	zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8)
+#define EA_INDY	zad = OPR8; \
+	base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y
+
+// 1 when indexing crossed a page boundary (costs an extra cycle)
+#define PAGE_CROSS	(((base ^ addr) & 0xFF00) != 0)
+
+// Operations on M
+#define DO_ORA	A |= M; SET_NZ(A)
+#define DO_AND	A &= M; SET_NZ(A)
+#define DO_EOR	A ^= M; SET_NZ(A)
+#define DO_ADD	r = A + M + (SR & C); SET_C(r); SET_V(A, M, r); A = r; SET_NZ(A)
+#define DO_ADC	if (SR & D) { adc_decimal(&A, &SR, M); } else { DO_ADD; }
+#define DO_SBC	if (SR & D) { sbc_decimal(&A, &SR, M); } else { M = ~M; DO_ADD; }
+#define DO_CMP(reg)	r = (reg) + (byte)~M + 1; SET_C(r); SET_NZ(r)
+#define DO_BIT	SR = (SR & ~(N | V | Z)) | (M & (N | V)) | ((A & M) ? 0 : Z)
+#define DO_ASL	SR = (SR & ~C) | (M >> 7); M <<= 1; SET_NZ(M)
+#define DO_LSR	SR = (SR & ~C) | (M & C); M >>= 1; SET_NZ(M)
+#define DO_ROL	r = (M << 1) | (SR & C); SR = (SR & ~C) | (M >> 7); M = r; SET_NZ(M)
+#define DO_ROR	r = (M >> 1) | ((SR & C) << 7); SR = (SR & ~C) | (M & C); M = r; \
+	SET_NZ(M)
+#define DO_LOAD(reg)	reg = M; SET_NZ(reg)
+
+// Stack
+// 	Pushes go through WR, so an engine can watch for code being written
+#define PUSH(v)	WR(0x100 + SP, (v)); SP--
+#define PULL(v)	SP++; v = read_stack(bus, SP)
+
+// Branch on cond
+// 	Taken branches add 1 cycle, plus 1 more when crossing a page
+#define BRANCH(cond) \
+	M = OPR8; \
+	PC += 2; \
+	if (cond) \
+	{ \
+		addr = PC + (signed char)M; \
+		cycles += ((PC ^ addr) & 0xFF00) ? 4 : 3; \
+		PC = addr; \
+	} \
+	else \
+	{ \
+		cycles += 2; \
+	} \
+	DISPATCH()
+
+#ifdef THREADED_GOTO
+// Label for each opcode, in order
+// 	Undefined opcodes run as NOP, the same as the instruction tables
+#define OPCODE_LABELS \
+	&&op_00, &&op_01, &&op_EA, &&op_EA, &&op_EA, &&op_05, &&op_06, &&op_EA, \
+	&&op_08, &&op_09, &&op_0A, &&op_EA, &&op_EA, &&op_0D, &&op_0E, &&op_EA, \
+	&&op_10, &&op_11, &&op_EA, &&op_EA, &&op_EA, &&op_15, &&op_16, &&op_EA, \
+	&&op_18, &&op_19, &&op_EA, &&op_EA, &&op_EA, &&op_1D, &&op_1E, &&op_EA, \
+	&&op_20, &&op_21, &&op_EA, &&op_EA, &&op_24, &&op_25, &&op_26, &&op_EA, \
+	&&op_28, &&op_29, &&op_2A, &&op_EA, &&op_2C, &&op_2D, &&op_2E, &&op_EA, \
+	&&op_30, &&op_31, &&op_EA, &&op_EA, &&op_EA, &&op_35, &&op_36, &&op_EA, \
+	&&op_38, &&op_39, &&op_EA, &&op_EA, &&op_EA, &&op_3D, &&op_3E, &&op_EA, \
+	&&op_40, &&op_41, &&op_EA, &&op_EA, &&op_EA, &&op_45, &&op_46, &&op_EA, \
+	&&op_48, &&op_49, &&op_4A, &&op_EA, &&op_4C, &&op_4D, &&op_4E, &&op_EA, \
+	&&op_50, &&op_51, &&op_EA, &&op_EA, &&op_EA, &&op_55, &&op_56, &&op_EA, \
+	&&op_58, &&op_59, &&op_EA, &&op_EA, &&op_EA, &&op_5D, &&op_5E, &&op_EA, \
+	&&op_60, &&op_61, &&op_EA, &&op_EA, &&op_EA, &&op_65, &&op_66, &&op_EA, \
+	&&op_68, &&op_69, &&op_6A, &&op_EA, &&op_6C, &&op_6D, &&op_6E, &&op_EA, \
+	&&op_70, &&op_71, &&op_EA, &&op_EA, &&op_EA, &&op_75, &&op_76, &&op_EA, \
+	&&op_78, &&op_79, &&op_EA, &&op_EA, &&op_EA, &&op_7D, &&op_7E, &&op_EA, \
+	&&op_EA, &&op_81, &&op_EA, &&op_EA, &&op_84, &&op_85, &&op_86, &&op_EA, \
+	&&op_88, &&op_EA, &&op_8A, &&op_EA, &&op_8C, &&op_8D, &&op_8E, &&op_EA, \
+	&&op_90, &&op_91, &&op_EA, &&op_EA, &&op_94, &&op_95, &&op_96, &&op_EA, \
+	&&op_98, &&op_99, &&op_9A, &&op_EA, &&op_EA, &&op_9D, &&op_EA, &&op_EA, \
+	&&op_A0, &&op_A1, &&op_A2, &&op_EA, &&op_A4, &&op_A5, &&op_A6, &&op_EA, \
+	&&op_A8, &&op_A9, &&op_AA, &&op_EA, &&op_AC, &&op_AD, &&op_AE, &&op_EA, \
+	&&op_B0, &&op_B1, &&op_EA, &&op_EA, &&op_B4, &&op_B5, &&op_B6, &&op_EA, \
+	&&op_B8, &&op_B9, &&op_BA, &&op_EA, &&op_BC, &&op_BD, &&op_BE, &&op_EA, \
+	&&op_C0, &&op_C1, &&op_EA, &&op_EA, &&op_C4, &&op_C5, &&op_C6, &&op_EA, \
+	&&op_C8, &&op_C9, &&op_CA, &&op_EA, &&op_CC, &&op_CD, &&op_CE, &&op_EA, \
+	&&op_D0, &&op_D1, &&op_EA, &&op_EA, &&op_EA, &&op_D5, &&op_D6, &&op_EA, \
+	&&op_D8, &&op_D9, &&op_EA, &&op_EA, &&op_EA, &&op_DD, &&op_DE, &&op_EA, \
+	&&op_E0, &&op_E1, &&op_EA, &&op_EA, &&op_E4, &&op_E5, &&op_E6, &&op_EA, \
+	&&op_E8, &&op_E9, &&op_EA, &&op_EA, &&op_EC, &&op_ED, &&op_EE, &&op_EA, \
+	&&op_F0, &&op_F1, &&op_EA, &&op_EA, &&op_EA, &&op_F5, &&op_F6, &&op_EA, \
+	&&op_F8, &&op_F9, &&op_EA, &&op_EA, &&op_EA, &&op_FD, &&op_FE, &&op_EA
+#endif
+
+#endif
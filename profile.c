@@ -0,0 +1,256 @@
+// profile.c
+//
+// 6502 emulator program
+// 	Guest code profiler
+//
+// Instructions and cycles are kept in a flat array for each PC, so
+// 	counting one is two adds.  The call tree is only moved around on a
+// 	JSR, RTS or RTI.  Each node holds the cycles spent in its own
+// 	subroutine, which is what a collapsed stack line wants.
+//
+// Brian K. Niece
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "profile.h"
+
+// Nodes allocated at first, doubled as needed
+#define PROFILE_NODES 256
+
+static int add_node(profile *p, word func, int parent)
+// Make func a child of parent
+// returns the new node
+// 		-1 if there is no room for it
+{
+	profile_node *node;
+
+	if (p->nnodes == p->size)
+	{
+		node = realloc(p->nodes, 2 * p->size * sizeof(profile_node));
+		if (node == NULL)
+		{
+			return -1;
+		}
+		p->nodes = node;
+		p->size *= 2;
+	}
+
+	node = &p->nodes[p->nnodes];
+	node->func = func;
+	node->parent = parent;
+	node->child = -1;
+	node->sibling = -1;
+	node->depth = 0;
+	node->cycles = 0;
+	if (parent >= 0)
+	{
+		node->depth = p->nodes[parent].depth + 1;
+		node->sibling = p->nodes[parent].child;
+		p->nodes[parent].child = p->nnodes;
+	}
+
+	return p->nnodes++;
+}
+
+static int find_child(profile *p, int parent, word func)
+// The node for func called from parent, made if it's the first call
+// 	Past PROFILE_DEPTH, or out of memory, the parent stands in for it
+{
+	int n;
+
+	for (n = p->nodes[parent].child; n >= 0; n = p->nodes[n].sibling)
+	{
+		if (p->nodes[n].func == func)
+		{
+			return n;
+		}
+	}
+
+	if (p->nodes[parent].depth >= PROFILE_DEPTH)
+	{
+		return parent;
+	}
+	n = add_node(p, func, parent);
+
+	return (n >= 0) ? n : parent;
+}
+
+int init_profile(profile *p, word entry, unsigned long long every)
+{
+	p->total = 0;
+	p->every = every;
+	p->base = 0xFF;
+
+	p->nnodes = 0;
+	p->size = PROFILE_NODES;
+	p->count = calloc(MAX_MEM, sizeof(unsigned long long));
+	p->cycles = calloc(MAX_MEM, sizeof(unsigned long long));
+	p->nodes = malloc(p->size * sizeof(profile_node));
+	if ((p->count == NULL) || (p->cycles == NULL) || (p->nodes == NULL))
+	{
+		free_profile(p);
+		return -1;
+	}
+	p->current = add_node(p, entry, -1);
+
+	return 0;
+}
+
+void free_profile(profile *p)
+{
+	free(p->count);
+	free(p->cycles);
+	free(p->nodes);
+	p->count = NULL;
+	p->cycles = NULL;
+	p->nodes = NULL;
+}
+
+void profile_start(profile *p, CPU *cpu)
+{
+	p->current = 0;
+	p->base = cpu->SP;
+}
+
+void profile_call(profile *p, word func)
+{
+	p->current = find_child(p, p->current, func);
+}
+
+void profile_return(profile *p)
+// A return from the root, say to code that pushed its own address, stays
+// 	at the root
+{
+	if (p->nodes[p->current].parent >= 0)
+	{
+		p->current = p->nodes[p->current].parent;
+	}
+}
+
+void profile_sample(profile *p, CPU *cpu, unsigned long long cycles)
+{
+	word calls[PROFILE_DEPTH];
+	int depth = 0;
+	int node = 0;
+	word ret;
+
+	p->count[cpu->PC] += p->every;
+	p->cycles[cpu->PC] += cycles;
+	p->total += cycles;
+
+	// Innermost call first, its return address is nearest the top
+	// 	The stack wraps around page 1, as it does when SP starts at 0
+	for (byte s = cpu->SP; (byte)(p->base - s) >= 2; s++)
+	{
+		ret = peek(cpu->bus, 0x100 + (byte)(s + 1)) |
+			(peek(cpu->bus, 0x100 + (byte)(s + 2)) << 8);
+		if (peek(cpu->bus, (word)(ret - 2)) == 0x20)
+		{
+			calls[depth++] = peek(cpu->bus, (word)(ret - 1)) |
+				(peek(cpu->bus, ret) << 8);
+			if (depth == PROFILE_DEPTH)
+			{
+				break;
+			}
+			s++;
+		}
+	}
+
+	// Down the tree from the root, outermost call first
+	while (depth > 0)
+	{
+		node = find_child(p, node, calls[--depth]);
+	}
+	p->nodes[node].cycles += cycles;
+}
+
+static profile *sort_profile;
+
+static int by_cycles(const void *a, const void *b)
+// qsort order for PCs, most cycles first, then by address
+{
+	unsigned long long ca = sort_profile->cycles[*(const word *)a];
+	unsigned long long cb = sort_profile->cycles[*(const word *)b];
+
+	if (ca != cb)
+	{
+		return (ca < cb) ? 1 : -1;
+	}
+	return *(const word *)a - *(const word *)b;
+}
+
+void print_hotspots(profile *p, int n)
+{
+	word *pcs = malloc(MAX_MEM * sizeof(word));
+	int used = 0;
+
+	if (pcs == NULL)
+	{
+		return;
+	}
+	for (int pc = 0; pc < MAX_MEM; pc++)
+	{
+		if (p->cycles[pc] > 0)
+		{
+			pcs[used++] = pc;
+		}
+	}
+	sort_profile = p;
+	qsort(pcs, used, sizeof(word), by_cycles);
+
+	printf("\nHot spots%s:\n", (p->every > 0) ? " (sampled)" : "");
+	printf("PC      Cycles          %%      Instructions\n");
+	for (int i = 0; (i < n) && (i < used); i++)
+	{
+		printf("0x%04X  %-14llu  %5.2f  %llu\n", pcs[i], p->cycles[pcs[i]],
+			100.0 * p->cycles[pcs[i]] / p->total, p->count[pcs[i]]);
+	}
+	free(pcs);
+}
+
+static int write_node(profile *p, FILE *file, int n, char *path, int len)
+// The line for node n if it used any cycles, then its children's
+// 	path holds the subroutines above it, len characters of them
+{
+	profile_node *node = &p->nodes[n];
+
+	len += sprintf(path + len, (node->parent >= 0) ? ";0x%04X" : "0x%04X",
+		node->func);
+	if ((node->cycles > 0) &&
+			(fprintf(file, "%s %llu\n", path, node->cycles) < 0))
+	{
+		return -2;
+	}
+
+	for (int c = node->child; c >= 0; c = p->nodes[c].sibling)
+	{
+		if (write_node(p, file, c, path, len) != 0)
+		{
+			return -2;
+		}
+	}
+
+	return 0;
+}
+
+int write_collapsed(profile *p, char *filename)
+{
+	FILE *file;
+	char path[(PROFILE_DEPTH + 1) * 7 + 1];
+	int r;
+
+	file = fopen(filename, "w");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	r = write_node(p, file, 0, path, 0);
+	if (fclose(file) != 0)
+	{
+		r = -2;
+	}
+
+	return r;
+}
@@ -0,0 +1,100 @@
+// profile.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Guest code profiler
+//
+// Brian K. Niece
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+
+#include "cpu.h"
+
+// Deepest call stack followed, deeper calls count in the caller
+#define PROFILE_DEPTH 64
+
+// Number of PCs printed in the hot spot report
+#define PROFILE_HOT_SIZE 20
+
+// A subroutine as reached by one path of calls
+// 	The nodes form a call tree, the root is the program's entry.
+typedef struct profile_node
+{
+	word func;					// subroutine address
+	int parent;					// -1 for the root
+	int child;					// first subroutine it called, -1 for none
+	int sibling;				// next subroutine its parent called
+	int depth;
+	unsigned long long cycles;	// spent in func itself by this path
+} profile_node;
+
+// Instructions and cycles at each PC, and the call tree
+// 	Counted exactly by profile_op from the trace hook, or estimated by
+// 	profile_sample from samples.
+typedef struct profile
+{
+	unsigned long long *count;				// instructions started at each PC
+	unsigned long long *cycles;				// MAX_MEM of each
+	unsigned long long total;				// cycles in all
+	profile_node *nodes;
+	int nnodes;
+	int size;					// nodes allocated
+	int current;				// node for the subroutine running now
+	byte base;					// SP when the run started
+	unsigned long long every;	// instructions a sample stands for, 0 if exact
+} profile;
+
+int init_profile(profile *p, word entry, unsigned long long every);
+	// entry names the root of the call tree, every is 0 for profile_op
+	// returns 0 on success
+	// 		-1 if the counts or call tree can't be allocated
+void free_profile(profile *p);
+void profile_start(profile *p, CPU *cpu);
+	// Before each run, back at the root with the stack empty at cpu's SP
+
+// Follow a call or return, for profile_op
+void profile_call(profile *p, word func);
+void profile_return(profile *p);
+
+// Count one instruction
+// 	Calls and returns move around the call tree.  RTS and RTI are
+// 	counted in the subroutine they leave, JSR in the one it leaves from.
+static inline void profile_op(profile *p, word addr, byte op, word operand,
+		int cycles)
+{
+	p->count[addr]++;
+	p->cycles[addr] += cycles;
+	p->total += cycles;
+	p->nodes[p->current].cycles += cycles;
+
+	if (op == 0x20)
+	{
+		profile_call(p, operand);
+	}
+	else if ((op == 0x60) || (op == 0x40))
+	{
+		profile_return(p);
+	}
+}
+
+void profile_sample(profile *p, CPU *cpu, unsigned long long cycles);
+	// Charge cycles and every instructions to the PC about to run
+	// 	The call stack is found from the return addresses on the 6502
+	// 	stack above where it started, a pair of bytes is taken as one if
+	// 	there is a JSR just before where it points.  Data pushed on the
+	// 	stack can look like a return address, so the stacks are a good
+	// 	guess, not exact.
+
+void print_hotspots(profile *p, int n);
+	// The n PCs that used the most cycles, most first
+int write_collapsed(profile *p, char *filename);
+	// A line for each path of calls that used cycles, the subroutines
+	// 	from the root separated by ; and then the cycles, the collapsed
+	// 	stack format flame graph tools read
+	// returns 0 on success
+	// 		-1 on file open error
+	// 		-2 on file write error
+
+#endif
@@ -0,0 +1,740 @@
+// recomp.c
+//
+// 6502 emulator program
+// 	Ahead-of-time recompiler, translates a code image into C
+//
+// Brian K. Niece
+//
+// em6502rc reads a code image, follows its control flow from the reset
+// 	vector, and writes a C file with a label for every instruction it
+// 	finds.  Each label holds the instruction body from opbodies.h with
+// 	the operand filled in, followed by a goto to the next one, so the C
+// 	compiler sees the whole program at once.
+//
+// The C file defines run_recompiled() (recomp.h).  Build it into the
+// 	emulator with
+// 		make em6502r PROGRAM=program.c
+// 	and run it with -E 4.
+//
+// Anything that can't be known ahead of time runs on the table handlers:
+// 	RTS, RTI and JMP (ind) look up their target at run time and hand
+// 	over to the handlers if there's no label for it, and a write into
+// 	a translated instruction hands over for the rest of the run.  The
+// 	handlers give control back to the translation whenever they reach
+// 	an address that has a label.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "em6502.h"
+#include "instructions.h"
+#include "version.h"
+
+// How each instruction ends
+enum
+{
+	RC_PLAIN = 0,	// falls through to the next instruction
+	RC_BRANCH,		// conditional branch
+	RC_JMP,			// JMP abs
+	RC_JMPI,		// JMP ind, target known at run time
+	RC_JSR,			// JSR abs
+	RC_RTS,			// RTS, target known at run time
+	RC_RTI,			// RTI, target known at run time
+	RC_BRK			// BRK ends the program
+};
+
+struct rc_op
+{
+	int kind;
+	const char *mnemonic;
+	const char *body;		// C statements, or the branch condition
+	const char *cycles;		// C expression for the cycle count
+};
+
+// Instruction bodies from opbodies.h with the EA_ macros written out
+// 	OPR8 and OPR16 are replaced with the operand.  Undefined opcodes
+// 	are left empty and run as NOP.
+static const struct rc_op rc_ops[256] =
+{
+	[0x00] = { RC_BRK, "BRK", "", "7" },
+	[0x01] = { RC_PLAIN, "ORA X,ind", "zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8); M = RD(addr); DO_ORA;", "6" },
+	[0x05] = { RC_PLAIN, "ORA zpg", "addr = OPR8; M = RDZ(addr); DO_ORA;", "3" },
+	[0x06] = { RC_PLAIN, "ASL zpg", "addr = OPR8; M = RDZ(addr); DO_ASL; WR(addr, M);", "5" },
+	[0x08] = { RC_PLAIN, "PHP", "PUSH(SR | B);", "3" },
+	[0x09] = { RC_PLAIN, "ORA #", "M = OPR8; DO_ORA;", "2" },
+	[0x0A] = { RC_PLAIN, "ASL A", "M = A; DO_ASL; A = M;", "2" },
+	[0x0D] = { RC_PLAIN, "ORA abs", "addr = OPR16; M = RD(addr); DO_ORA;", "4" },
+	[0x0E] = { RC_PLAIN, "ASL abs", "addr = OPR16; M = RD(addr); DO_ASL; WR(addr, M);", "6" },
+	[0x10] = { RC_BRANCH, "BPL rel", "(SR & N) == 0", "2" },
+	[0x11] = { RC_PLAIN, "ORA ind,Y", "zad = OPR8; base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y; M = RD(addr); DO_ORA;", "5 + PAGE_CROSS" },
+	[0x15] = { RC_PLAIN, "ORA zpg,X", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_ORA;", "4" },
+	[0x16] = { RC_PLAIN, "ASL zpgX", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_ASL; WR(addr, M);", "6" },
+	[0x18] = { RC_PLAIN, "CLC", "SR &= ~C;", "2" },
+	[0x19] = { RC_PLAIN, "ORA absY", "base = OPR16; addr = base + Y; M = RD(addr); DO_ORA;", "4 + PAGE_CROSS" },
+	[0x1D] = { RC_PLAIN, "ORA absX", "base = OPR16; addr = base + X; M = RD(addr); DO_ORA;", "4 + PAGE_CROSS" },
+	[0x1E] = { RC_PLAIN, "ASL absX", "base = OPR16; addr = base + X; M = RD(addr); DO_ASL; WR(addr, M);", "7" },
+	[0x20] = { RC_JSR, "JSR abs", "", "6" },
+	[0x21] = { RC_PLAIN, "AND X,ind", "zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8); M = RD(addr); DO_AND;", "6" },
+	[0x24] = { RC_PLAIN, "BIT zpg", "addr = OPR8; M = RDZ(addr); DO_BIT;", "3" },
+	[0x25] = { RC_PLAIN, "AND zpg", "addr = OPR8; M = RDZ(addr); DO_AND;", "3" },
+	[0x26] = { RC_PLAIN, "ROL zpg", "addr = OPR8; M = RDZ(addr); DO_ROL; WR(addr, M);", "5" },
+	[0x28] = { RC_PLAIN, "PLP", "PULL(SR);", "4" },
+	[0x29] = { RC_PLAIN, "AND #", "M = OPR8; DO_AND;", "2" },
+	[0x2A] = { RC_PLAIN, "ROL A", "M = A; DO_ROL; A = M;", "2" },
+	[0x2C] = { RC_PLAIN, "BIT abs", "addr = OPR16; M = RD(addr); DO_BIT;", "4" },
+	[0x2D] = { RC_PLAIN, "AND abs", "addr = OPR16; M = RD(addr); DO_AND;", "4" },
+	[0x2E] = { RC_PLAIN, "ROL abs", "addr = OPR16; M = RD(addr); DO_ROL; WR(addr, M);", "6" },
+	[0x30] = { RC_BRANCH, "BMI rel", "(SR & N) != 0", "2" },
+	[0x31] = { RC_PLAIN, "AND ind,Y", "zad = OPR8; base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y; M = RD(addr); DO_AND;", "5 + PAGE_CROSS" },
+	[0x35] = { RC_PLAIN, "AND zpg,X", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_AND;", "4" },
+	[0x36] = { RC_PLAIN, "ROL zpgX", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_ROL; WR(addr, M);", "6" },
+	[0x38] = { RC_PLAIN, "SEC", "SR |= C;", "2" },
+	[0x39] = { RC_PLAIN, "AND absY", "base = OPR16; addr = base + Y; M = RD(addr); DO_AND;", "4 + PAGE_CROSS" },
+	[0x3D] = { RC_PLAIN, "AND absX", "base = OPR16; addr = base + X; M = RD(addr); DO_AND;", "4 + PAGE_CROSS" },
+	[0x3E] = { RC_PLAIN, "ROL absX", "base = OPR16; addr = base + X; M = RD(addr); DO_ROL; WR(addr, M);", "7" },
+	[0x40] = { RC_RTI, "RTI impl", "", "6" },
+	[0x41] = { RC_PLAIN, "EOR X,ind", "zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8); M = RD(addr); DO_EOR;", "6" },
+	[0x45] = { RC_PLAIN, "EOR zpg", "addr = OPR8; M = RDZ(addr); DO_EOR;", "3" },
+	[0x46] = { RC_PLAIN, "LSR zpg", "addr = OPR8; M = RDZ(addr); DO_LSR; WR(addr, M);", "5" },
+	[0x48] = { RC_PLAIN, "PHA", "PUSH(A);", "3" },
+	[0x49] = { RC_PLAIN, "EOR #", "M = OPR8; DO_EOR;", "2" },
+	[0x4A] = { RC_PLAIN, "LSR A", "M = A; DO_LSR; A = M;", "2" },
+	[0x4C] = { RC_JMP, "JMP abs", "", "3" },
+	[0x4D] = { RC_PLAIN, "EOR abs", "addr = OPR16; M = RD(addr); DO_EOR;", "4" },
+	[0x4E] = { RC_PLAIN, "LSR abs", "addr = OPR16; M = RD(addr); DO_LSR; WR(addr, M);", "6" },
+	[0x50] = { RC_BRANCH, "BVC rel", "(SR & V) == 0", "2" },
+	[0x51] = { RC_PLAIN, "EOR ind,Y", "zad = OPR8; base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y; M = RD(addr); DO_EOR;", "5 + PAGE_CROSS" },
+	[0x55] = { RC_PLAIN, "EOR zpg,X", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_EOR;", "4" },
+	[0x56] = { RC_PLAIN, "LSR zpgX", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_LSR; WR(addr, M);", "6" },
+	[0x58] = { RC_PLAIN, "CLI", "SR &= ~I;", "2" },
+	[0x59] = { RC_PLAIN, "EOR absY", "base = OPR16; addr = base + Y; M = RD(addr); DO_EOR;", "4 + PAGE_CROSS" },
+	[0x5D] = { RC_PLAIN, "EOR absX", "base = OPR16; addr = base + X; M = RD(addr); DO_EOR;", "4 + PAGE_CROSS" },
+	[0x5E] = { RC_PLAIN, "LSR absX", "base = OPR16; addr = base + X; M = RD(addr); DO_LSR; WR(addr, M);", "7" },
+	[0x60] = { RC_RTS, "RTS impl", "", "6" },
+	[0x61] = { RC_PLAIN, "ADC X,ind", "zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8); M = RD(addr); DO_ADC;", "6" },
+	[0x65] = { RC_PLAIN, "ADC zpg", "addr = OPR8; M = RDZ(addr); DO_ADC;", "3" },
+	[0x66] = { RC_PLAIN, "ROR zpg", "addr = OPR8; M = RDZ(addr); DO_ROR; WR(addr, M);", "5" },
+	[0x68] = { RC_PLAIN, "PLA", "PULL(A); SET_NZ(A);", "4" },
+	[0x69] = { RC_PLAIN, "ADC #", "M = OPR8; DO_ADC;", "2" },
+	[0x6A] = { RC_PLAIN, "ROR A", "M = A; DO_ROR; A = M;", "2" },
+	[0x6C] = { RC_JMPI, "JMP ind", "", "5" },
+	[0x6D] = { RC_PLAIN, "ADC abs", "addr = OPR16; M = RD(addr); DO_ADC;", "4" },
+	[0x6E] = { RC_PLAIN, "ROR abs", "addr = OPR16; M = RD(addr); DO_ROR; WR(addr, M);", "6" },
+	[0x70] = { RC_BRANCH, "BVS rel", "(SR & V) != 0", "2" },
+	[0x71] = { RC_PLAIN, "ADC ind,Y", "zad = OPR8; base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y; M = RD(addr); DO_ADC;", "5 + PAGE_CROSS" },
+	[0x75] = { RC_PLAIN, "ADC zpg,X", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_ADC;", "4" },
+	[0x76] = { RC_PLAIN, "ROR zpgX", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_ROR; WR(addr, M);", "6" },
+	[0x78] = { RC_PLAIN, "SEI", "SR |= I;", "2" },
+	[0x79] = { RC_PLAIN, "ADC absY", "base = OPR16; addr = base + Y; M = RD(addr); DO_ADC;", "4 + PAGE_CROSS" },
+	[0x7D] = { RC_PLAIN, "ADC absX", "base = OPR16; addr = base + X; M = RD(addr); DO_ADC;", "4 + PAGE_CROSS" },
+	[0x7E] = { RC_PLAIN, "ROR absX", "base = OPR16; addr = base + X; M = RD(addr); DO_ROR; WR(addr, M);", "7" },
+	[0x81] = { RC_PLAIN, "STA X,ind", "zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8); WR(addr, A);", "6" },
+	[0x84] = { RC_PLAIN, "STY zpg", "addr = OPR8; WR(addr, Y);", "3" },
+	[0x85] = { RC_PLAIN, "STA zpg", "addr = OPR8; WR(addr, A);", "3" },
+	[0x86] = { RC_PLAIN, "STX zpg", "addr = OPR8; WR(addr, X);", "3" },
+	[0x88] = { RC_PLAIN, "DEY", "Y--; SET_NZ(Y);", "2" },
+	[0x8A] = { RC_PLAIN, "TXA", "A = X; SET_NZ(A);", "2" },
+	[0x8C] = { RC_PLAIN, "STY abs", "addr = OPR16; WR(addr, Y);", "4" },
+	[0x8D] = { RC_PLAIN, "STA abs", "addr = OPR16; WR(addr, A);", "4" },
+	[0x8E] = { RC_PLAIN, "STX abs", "addr = OPR16; WR(addr, X);", "4" },
+	[0x90] = { RC_BRANCH, "BCC rel", "(SR & C) == 0", "2" },
+	[0x91] = { RC_PLAIN, "STA ind,Y", "zad = OPR8; base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y; WR(addr, A);", "6" },
+	[0x94] = { RC_PLAIN, "STY zpg,X", "addr = (byte)(OPR8 + X); WR(addr, Y);", "4" },
+	[0x95] = { RC_PLAIN, "STA zpg,X", "addr = (byte)(OPR8 + X); WR(addr, A);", "4" },
+	[0x96] = { RC_PLAIN, "STX zpg,Y", "addr = (byte)(OPR8 + Y); WR(addr, X);", "4" },
+	[0x98] = { RC_PLAIN, "TYA", "A = Y; SET_NZ(A);", "2" },
+	[0x99] = { RC_PLAIN, "STA absY", "base = OPR16; addr = base + Y; WR(addr, A);", "5" },
+	[0x9A] = { RC_PLAIN, "TXS", "SP = X;", "2" },
+	[0x9D] = { RC_PLAIN, "STA absX", "base = OPR16; addr = base + X; WR(addr, A);", "5" },
+	[0xA0] = { RC_PLAIN, "LDY #", "M = OPR8; DO_LOAD(Y);", "2" },
+	[0xA1] = { RC_PLAIN, "LDA X,ind", "zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8); M = RD(addr); DO_LOAD(A);", "6" },
+	[0xA2] = { RC_PLAIN, "LDX #", "M = OPR8; DO_LOAD(X);", "2" },
+	[0xA4] = { RC_PLAIN, "LDY zpg", "addr = OPR8; M = RDZ(addr); DO_LOAD(Y);", "3" },
+	[0xA5] = { RC_PLAIN, "LDA zpg", "addr = OPR8; M = RDZ(addr); DO_LOAD(A);", "3" },
+	[0xA6] = { RC_PLAIN, "LDX zpg", "addr = OPR8; M = RDZ(addr); DO_LOAD(X);", "3" },
+	[0xA8] = { RC_PLAIN, "TAY", "Y = A; SET_NZ(Y);", "2" },
+	[0xA9] = { RC_PLAIN, "LDA #", "M = OPR8; DO_LOAD(A);", "2" },
+	[0xAA] = { RC_PLAIN, "TAX", "X = A; SET_NZ(X);", "2" },
+	[0xAC] = { RC_PLAIN, "LDY abs", "addr = OPR16; M = RD(addr); DO_LOAD(Y);", "4" },
+	[0xAD] = { RC_PLAIN, "LDA abs", "addr = OPR16; M = RD(addr); DO_LOAD(A);", "4" },
+	[0xAE] = { RC_PLAIN, "LDX abs", "addr = OPR16; M = RD(addr); DO_LOAD(X);", "4" },
+	[0xB0] = { RC_BRANCH, "BCS rel", "(SR & C) != 0", "2" },
+	[0xB1] = { RC_PLAIN, "LDA ind,Y", "zad = OPR8; base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y; M = RD(addr); DO_LOAD(A);", "5 + PAGE_CROSS" },
+	[0xB4] = { RC_PLAIN, "LDY zpg,X", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_LOAD(Y);", "4" },
+	[0xB5] = { RC_PLAIN, "LDA zpg,X", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_LOAD(A);", "4" },
+	[0xB6] = { RC_PLAIN, "LDX zpg,Y", "addr = (byte)(OPR8 + Y); M = RDZ(addr); DO_LOAD(X);", "4" },
+	[0xB8] = { RC_PLAIN, "CLV", "SR &= ~V;", "2" },
+	[0xB9] = { RC_PLAIN, "LDA absY", "base = OPR16; addr = base + Y; M = RD(addr); DO_LOAD(A);", "4 + PAGE_CROSS" },
+	[0xBA] = { RC_PLAIN, "TSX", "X = SP;", "2" },
+	[0xBC] = { RC_PLAIN, "LDY absX", "base = OPR16; addr = base + X; M = RD(addr); DO_LOAD(Y);", "4 + PAGE_CROSS" },
+	[0xBD] = { RC_PLAIN, "LDA absX", "base = OPR16; addr = base + X; M = RD(addr); DO_LOAD(A);", "4 + PAGE_CROSS" },
+	[0xBE] = { RC_PLAIN, "LDX absY", "base = OPR16; addr = base + Y; M = RD(addr); DO_LOAD(X);", "4 + PAGE_CROSS" },
+	[0xC0] = { RC_PLAIN, "CPY #", "M = OPR8; DO_CMP(Y);", "2" },
+	[0xC1] = { RC_PLAIN, "CMP Xind", "zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8); M = RD(addr); DO_CMP(A);", "6" },
+	[0xC4] = { RC_PLAIN, "CPY zpg", "addr = OPR8; M = RDZ(addr); DO_CMP(Y);", "3" },
+	[0xC5] = { RC_PLAIN, "CMP zpg", "addr = OPR8; M = RDZ(addr); DO_CMP(A);", "3" },
+	[0xC6] = { RC_PLAIN, "DEC zpg", "addr = OPR8; M = RDZ(addr) - 1; SET_NZ(M); WR(addr, M);", "5" },
+	[0xC8] = { RC_PLAIN, "INY", "Y++; SET_NZ(Y);", "2" },
+	[0xC9] = { RC_PLAIN, "CMP #", "M = OPR8; DO_CMP(A);", "2" },
+	[0xCA] = { RC_PLAIN, "DEX", "X--; SET_NZ(X);", "2" },
+	[0xCC] = { RC_PLAIN, "CPY abs", "addr = OPR16; M = RD(addr); DO_CMP(Y);", "4" },
+	[0xCD] = { RC_PLAIN, "CMP abs", "addr = OPR16; M = RD(addr); DO_CMP(A);", "4" },
+	[0xCE] = { RC_PLAIN, "DEC abs", "addr = OPR16; M = RD(addr) - 1; SET_NZ(M); WR(addr, M);", "6" },
+	[0xD0] = { RC_BRANCH, "BNE rel", "(SR & Z) == 0", "2" },
+	[0xD1] = { RC_PLAIN, "CMP indY", "zad = OPR8; base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y; M = RD(addr); DO_CMP(A);", "5 + PAGE_CROSS" },
+	[0xD5] = { RC_PLAIN, "CMP zpgX", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_CMP(A);", "4" },
+	[0xD6] = { RC_PLAIN, "DEC zpgX", "addr = (byte)(OPR8 + X); M = RDZ(addr) - 1; SET_NZ(M); WR(addr, M);", "6" },
+	[0xD8] = { RC_PLAIN, "CLD", "SR &= ~D;", "2" },
+	[0xD9] = { RC_PLAIN, "CMP absY", "base = OPR16; addr = base + Y; M = RD(addr); DO_CMP(A);", "4 + PAGE_CROSS" },
+	[0xDD] = { RC_PLAIN, "CMP absX", "base = OPR16; addr = base + X; M = RD(addr); DO_CMP(A);", "4 + PAGE_CROSS" },
+	[0xDE] = { RC_PLAIN, "DEC absX", "base = OPR16; addr = base + X; M = RD(addr) - 1; SET_NZ(M); WR(addr, M);", "7" },
+	[0xE0] = { RC_PLAIN, "CPX #", "M = OPR8; DO_CMP(X);", "2" },
+	[0xE1] = { RC_PLAIN, "SBC X,ind", "zad = OPR8 + X; addr = RDZ(zad) + (RDZ(zad + 1) << 8); M = RD(addr); DO_SBC;", "6" },
+	[0xE4] = { RC_PLAIN, "CPX zpg", "addr = OPR8; M = RDZ(addr); DO_CMP(X);", "3" },
+	[0xE5] = { RC_PLAIN, "SBC zpg", "addr = OPR8; M = RDZ(addr); DO_SBC;", "3" },
+	[0xE6] = { RC_PLAIN, "INC zpg", "addr = OPR8; M = RDZ(addr) + 1; SET_NZ(M); WR(addr, M);", "5" },
+	[0xE8] = { RC_PLAIN, "INX", "X++; SET_NZ(X);", "2" },
+	[0xE9] = { RC_PLAIN, "SBC #", "M = OPR8; DO_SBC;", "2" },
+	[0xEA] = { RC_PLAIN, "NOP", "", "2" },
+	[0xEC] = { RC_PLAIN, "CPX abs", "addr = OPR16; M = RD(addr); DO_CMP(X);", "4" },
+	[0xED] = { RC_PLAIN, "SBC abs", "addr = OPR16; M = RD(addr); DO_SBC;", "4" },
+	[0xEE] = { RC_PLAIN, "INC abs", "addr = OPR16; M = RD(addr) + 1; SET_NZ(M); WR(addr, M);", "6" },
+	[0xF0] = { RC_BRANCH, "BEQ rel", "(SR & Z) != 0", "2" },
+	[0xF1] = { RC_PLAIN, "SBC ind,Y", "zad = OPR8; base = RDZ(zad) + (RDZ(zad + 1) << 8); addr = base + Y; M = RD(addr); DO_SBC;", "5 + PAGE_CROSS" },
+	[0xF5] = { RC_PLAIN, "SBC zpg,X", "addr = (byte)(OPR8 + X); M = RDZ(addr); DO_SBC;", "4" },
+	[0xF6] = { RC_PLAIN, "INC zpgX", "addr = (byte)(OPR8 + X); M = RDZ(addr) + 1; SET_NZ(M); WR(addr, M);", "6" },
+	[0xF8] = { RC_PLAIN, "SED", "SR |= D;", "2" },
+	[0xF9] = { RC_PLAIN, "SBC absY", "base = OPR16; addr = base + Y; M = RD(addr); DO_SBC;", "4 + PAGE_CROSS" },
+	[0xFD] = { RC_PLAIN, "SBC absX", "base = OPR16; addr = base + X; M = RD(addr); DO_SBC;", "4 + PAGE_CROSS" },
+	[0xFE] = { RC_PLAIN, "INC absX", "base = OPR16; addr = base + X; M = RD(addr) + 1; SET_NZ(M); WR(addr, M);", "7" },
+};
+
+// The program
+static byte image[MAX_MEM];
+static word image_base;
+static int image_len;
+
+// Translated instructions
+static byte is_insn[MAX_MEM];	// 1 if a translated instruction starts here
+static byte is_code[MAX_MEM];	// 1 if the byte is part of one
+
+static int in_image(int addr, int len)
+// Check that all of an instruction is in the program
+{
+	return (addr >= image_base) && (addr + len <= image_base + image_len);
+}
+
+static byte image_byte(word addr)
+{
+	return image[addr - image_base];
+}
+
+static word operand(word pc)
+// Operand of the instruction at pc
+{
+	switch (op_length[image_byte(pc)])
+	{
+		case 2:
+			return image_byte(pc + 1);
+		case 3:
+			return image_byte(pc + 1) + (image_byte(pc + 2) << 8);
+		default:
+			return 0;
+	}
+}
+
+static word branch_target(word pc)
+{
+	return pc + 2 + (signed char)image_byte(pc + 1);
+}
+
+static void find_code(word entry)
+// Mark every instruction reachable from entry
+// 	Targets of RTS, RTI and JMP (ind) aren't known, apart from the
+// 	return address after each JSR.
+{
+	// Each instruction adds at most two addresses
+	word *todo = malloc((2 * MAX_MEM + 1) * sizeof(word));
+	int n = 0;
+
+	todo[n++] = entry;
+	while (n > 0)
+	{
+		word pc = todo[--n];
+		byte op;
+		int len;
+
+		if ((is_insn[pc] != 0) || (in_image(pc, 1) == 0))
+		{
+			continue;
+		}
+		op = image_byte(pc);
+		len = op_length[op];
+		if (in_image(pc, len) == 0)
+		{
+			continue;
+		}
+
+		is_insn[pc] = 1;
+		for (int i = 0; i < len; i++)
+		{
+			is_code[pc + i] = 1;
+		}
+
+		switch (rc_ops[op].kind)
+		{
+			case RC_PLAIN:
+				todo[n++] = pc + len;
+				break;
+			case RC_BRANCH:
+				todo[n++] = pc + len;
+				todo[n++] = branch_target(pc);
+				break;
+			case RC_JMP:
+				todo[n++] = operand(pc);
+				break;
+			case RC_JSR:
+				todo[n++] = pc + len;
+				todo[n++] = operand(pc);
+				break;
+			default:
+				break;
+		}
+	}
+
+	free(todo);
+}
+
+static void emit_body(FILE *out, const char *body, word opr)
+// Copy an instruction body with the operand filled in
+{
+	while (*body != '\0')
+	{
+		if (strncmp(body, "OPR16", 5) == 0)
+		{
+			fprintf(out, "0x%04X", opr);
+			body += 5;
+		}
+		else if (strncmp(body, "OPR8", 4) == 0)
+		{
+			fprintf(out, "0x%02X", opr & 0xFF);
+			body += 4;
+		}
+		else
+		{
+			fputc(*body++, out);
+		}
+	}
+}
+
+static void emit_goto(FILE *out, word target)
+// Continue at target, through the handlers if it wasn't translated
+{
+	if (is_insn[target] != 0)
+	{
+		fprintf(out, "\tgoto L_%04X;\n", target);
+	}
+	else
+	{
+		fprintf(out, "\tPC = 0x%04X;\n\tgoto interpret;\n", target);
+	}
+}
+
+static void emit_insn(FILE *out, word pc)
+// Translate one instruction
+{
+	byte op = image_byte(pc);
+	int len = op_length[op];
+	const struct rc_op *info = &rc_ops[op];
+	word opr = operand(pc);
+	word next = pc + len;
+	word target;
+	int writes;
+
+	fprintf(out, "\nL_%04X:\t// %-9s", pc, (info->mnemonic != NULL) ?
+		info->mnemonic : "NOP");
+	for (int i = 0; i < len; i++)
+	{
+		fprintf(out, " %02X", image_byte(pc + i));
+	}
+	fprintf(out, "\n");
+
+	switch (info->kind)
+	{
+		case RC_PLAIN:
+			// Undefined opcodes run as NOP
+			if ((info->body != NULL) && (info->body[0] != '\0'))
+			{
+				fprintf(out, "\t");
+				emit_body(out, info->body, opr);
+				fprintf(out, "\n");
+			}
+			fprintf(out, "\tcycles += %s;\n\tcount++;\n",
+				(info->cycles != NULL) ? info->cycles : "2");
+
+			// A write into translated code hands over to the handlers
+			writes = (info->body != NULL) && ((strstr(info->body, "WR(") != NULL) ||
+				(strstr(info->body, "PUSH(") != NULL));
+			if (writes)
+			{
+				fprintf(out, "\tif (smc)\n\t{\n\t\tPC = 0x%04X;\n"
+					"\t\tgoto interpret;\n\t}\n", next);
+			}
+
+			// Fall through when the next instruction is the next label
+			if ((is_insn[next] == 0) || (next <= pc))
+			{
+				emit_goto(out, next);
+			}
+			else
+			{
+				for (word a = pc + 1; a != next; a++)
+				{
+					if (is_insn[a] != 0)
+					{
+						emit_goto(out, next);
+						break;
+					}
+				}
+			}
+			break;
+
+		case RC_BRANCH:
+			// Taken branches add 1 cycle, plus 1 more when crossing a page
+			target = branch_target(pc);
+			fprintf(out, "\tcount++;\n\tif (%s)\n\t{\n\t\tcycles += %d;\n\t",
+				info->body, ((next ^ target) & 0xFF00) ? 4 : 3);
+			emit_goto(out, target);
+			fprintf(out, "\t}\n\tcycles += 2;\n");
+			emit_goto(out, next);
+			break;
+
+		case RC_JMP:
+			fprintf(out, "\tcycles += 3;\n\tcount++;\n");
+			emit_goto(out, opr);
+			break;
+
+		case RC_JMPI:
+			// The pointer high byte is fetched without carry into the next
+			// 	page, the same as a MOS 6502
+			fprintf(out, "\tPC = RD(0x%04X) + (RD(0x%04X) << 8);\n",
+				opr, (opr & 0xFF00) | ((opr + 1) & 0xFF));
+			fprintf(out, "\tcycles += 5;\n\tcount++;\n\tgoto dispatch;\n");
+			break;
+
+		case RC_JSR:
+			fprintf(out, "\tPUSH(0x%02X);\n\tPUSH(0x%02X);\n",
+				(word)(pc + 2) >> 8, (pc + 2) & 0xFF);
+			fprintf(out, "\tcycles += 6;\n\tcount++;\n");
+			fprintf(out, "\tif (smc)\n\t{\n\t\tPC = 0x%04X;\n"
+				"\t\tgoto interpret;\n\t}\n", opr);
+			emit_goto(out, opr);
+			break;
+
+		case RC_RTS:
+			fprintf(out, "\tPULL(M);\n\tPULL(addr);\n\tPC = M + (addr << 8) + 1;\n");
+			fprintf(out, "\tcycles += 6;\n\tcount++;\n\tgoto dispatch;\n");
+			break;
+
+		case RC_RTI:
+			fprintf(out, "\tPULL(SR);\n\tPULL(M);\n\tPULL(addr);\n"
+				"\tPC = M + (addr << 8);\n");
+			fprintf(out, "\tcycles += 6;\n\tcount++;\n\tgoto dispatch;\n");
+			break;
+
+		case RC_BRK:
+			// BRK ends the program, as in do_BRK_impl
+			fprintf(out, "\tPC = 0x%04X;\n\tcycles += 7;\n\tcount++;\n"
+				"\tgoto brk;\n", (word)(pc + 1));
+			break;
+	}
+}
+
+static void emit_map(FILE *out, const char *name, const byte *flags)
+// Bitmap of the addresses with a flag set, one bit per address
+{
+	fprintf(out, "static const byte %s[MAX_MEM / 8] =\n{\n", name);
+	for (int i = 0; i < MAX_MEM / 8; i++)
+	{
+		int bits = 0;
+		for (int b = 0; b < 8; b++)
+		{
+			bits |= (flags[i * 8 + b] != 0) << b;
+		}
+		if (bits != 0)
+		{
+			fprintf(out, "\t[0x%04X] = 0x%02X,\n", i, bits);
+		}
+	}
+	fprintf(out, "};\n\n");
+}
+
+static void emit_program(FILE *out, char *code_file, word entry)
+// Write the C file
+{
+	int count = 0;
+	int brk = 0;
+
+	for (int i = 0; i < MAX_MEM; i++)
+	{
+		count += is_insn[i];
+		if ((is_insn[i] != 0) && (image_byte(i) == 0x00))
+		{
+			brk = 1;
+		}
+	}
+
+	fprintf(out, "// Generated by em6502rc from %s, do not edit\n", code_file);
+	fprintf(out, "//\n");
+	fprintf(out, "// %d bytes at 0x%04X, entry 0x%04X, %d instructions\n\n",
+		image_len, image_base, entry, count);
+
+	fprintf(out, "#include <stddef.h>\n\n");
+	fprintf(out, "#include \"recomp.h\"\n");
+	fprintf(out, "#include \"instructions.h\"\n");
+	fprintf(out, "#include \"membus.h\"\n");
+	fprintf(out, "#include \"opcore.h\"\n\n");
+	fprintf(out, "#define WR(a, v)\twrite(bus, (word)(a), (v))\n");
+	fprintf(out, "#define IN_MAP(map, a)\t(((map)[(a) >> 3] >> ((a) & 7)) & 1)\n\n");
+
+	// The image, so a different program in memory isn't run by mistake
+	fprintf(out, "static const word image_base = 0x%04X;\n", image_base);
+	fprintf(out, "static const byte image[%d] =\n{", image_len);
+	for (int i = 0; i < image_len; i++)
+	{
+		fprintf(out, "%s0x%02X,", ((i % 12) == 0) ? "\n\t" : " ", image[i]);
+	}
+	fprintf(out, "\n};\n\n");
+
+	fprintf(out, "// Bytes of translated instructions, and where each one starts\n");
+	emit_map(out, "code_map", is_code);
+	emit_map(out, "insn_map", is_insn);
+
+	fprintf(out,
+		"static void code_write(void *smc, word addr, int len)\n"
+		"// A write landed in a page with translated code, or a bank\n"
+		"// \twas mapped over len bytes from addr\n"
+		"{\n"
+		"\tfor (int i = 0; i < len; i++)\n"
+		"\t{\n"
+		"\t\tif (IN_MAP(code_map, (word)(addr + i)))\n"
+		"\t\t{\n"
+		"\t\t\t*(int *)smc = 1;\n"
+		"\t\t}\n"
+		"\t}\n"
+		"}\n\n");
+
+	fprintf(out,
+		"void run_recompiled(CPU *cpu, unsigned long long *cycles_out,\n"
+		"\t\tunsigned long long *count_out)\n"
+		"{\n"
+		"\tmembus *bus = cpu->bus;\n"
+		"\tstruct opreturn opr;\n"
+		"\n"
+		"\t// Working copies of the registers\n"
+		"\tword PC = cpu->PC;\n"
+		"\tbyte SP = cpu->SP;\n"
+		"\tbyte A = cpu->A;\n"
+		"\tbyte X = cpu->X;\n"
+		"\tbyte Y = cpu->Y;\n"
+		"\tbyte SR = get_SR(cpu);\n"
+		"\n"
+		"\t// Scratch used by the instruction bodies\n"
+		"\tbyte M = 0, zad = 0;\n"
+		"\tword addr = 0, base = 0;\n"
+		"\tint r = 0;\n"
+		"\n"
+		"\tunsigned long long cycles = 0;\n"
+		"\tunsigned long long count = 0;\n"
+		"\n"
+		"\t// Set once the translated code no longer matches memory\n"
+		"\tint smc = 0;\n"
+		"\n"
+		"\tfor (int i = 0; i < (int)sizeof(image); i++)\n"
+		"\t{\n"
+		"\t\tword a = image_base + i;\n"
+		"\t\tif (IN_MAP(code_map, a) && (read(bus, a) != image[i]))\n"
+		"\t\t{\n"
+		"\t\t\tsmc = 1;\n"
+		"\t\t}\n"
+		"\t}\n"
+		"\n"
+		"\t// Watch for writes into translated code\n"
+		"\tfor (int pg = 0; pg < NUM_PAGES; pg++)\n"
+		"\t{\n"
+		"\t\tfor (int i = 0; i < PAGE_SIZE / 8; i++)\n"
+		"\t\t{\n"
+		"\t\t\tif (code_map[pg * PAGE_SIZE / 8 + i] != 0)\n"
+		"\t\t\t{\n"
+		"\t\t\t\tbus->pages[pg].attr |= PG_CODE;\n"
+		"\t\t\t}\n"
+		"\t\t}\n"
+		"\t}\n"
+		"\tbus->code_write = code_write;\n"
+		"\tbus->code_ctx = &smc;\n"
+		"\n"
+		"dispatch:\n"
+		"\tif (smc)\n"
+		"\t{\n"
+		"\t\tgoto interpret;\n"
+		"\t}\n"
+		"\tswitch (PC)\n"
+		"\t{\n");
+	for (int i = 0; i < MAX_MEM; i++)
+	{
+		if (is_insn[i] != 0)
+		{
+			fprintf(out, "\t\tcase 0x%04X: goto L_%04X;\n", i, i);
+		}
+	}
+	fprintf(out,
+		"\t\tdefault: goto interpret;\n"
+		"\t}\n");
+
+	for (int i = 0; i < MAX_MEM; i++)
+	{
+		if (is_insn[i] != 0)
+		{
+			emit_insn(out, i);
+		}
+	}
+
+	fprintf(out,
+		"\n"
+		"interpret:\n"
+		"\t// The table handlers run anything that wasn't translated, and\n"
+		"\t// \teverything after a write into translated code\n"
+		"\tcpu->PC = PC;\n"
+		"\tcpu->SP = SP;\n"
+		"\tcpu->A = A;\n"
+		"\tcpu->X = X;\n"
+		"\tcpu->Y = Y;\n"
+		"\tcpu->SR = SR;\n"
+		"\tdo\n"
+		"\t{\n"
+		"\t\tcpu->IR = read(bus, cpu->PC);\n"
+		"\t\topr = cpu->optable[(cpu->SR & D) != 0][cpu->IR](cpu);\n"
+		"\t\tcycles += opr.cycles;\n"
+		"\t\tcount++;\n"
+		"\t\tif (cpu->IR == 0x00)\n"
+		"\t\t{\n"
+		"\t\t\tgoto done;\n"
+		"\t\t}\n"
+		"\t} while (smc || !IN_MAP(insn_map, cpu->PC));\n"
+		"\tPC = cpu->PC;\n"
+		"\tSP = cpu->SP;\n"
+		"\tA = cpu->A;\n"
+		"\tX = cpu->X;\n"
+		"\tY = cpu->Y;\n"
+		"\tSR = get_SR(cpu);\n"
+		"\tgoto dispatch;\n"
+		"\n");
+
+	// Only needed if a BRK was translated
+	if (brk)
+	{
+		fprintf(out, "brk:\n"
+		"\tcpu->PC = PC;\n"
+		"\tcpu->SP = SP;\n"
+		"\tcpu->A = A;\n"
+		"\tcpu->X = X;\n"
+		"\tcpu->Y = Y;\n"
+		"\tcpu->SR = SR;\n"
+		"\tcpu->IR = 0x00;\n"
+		"\n");
+	}
+
+	fprintf(out,
+		"done:\n"
+		"\tfor (int pg = 0; pg < NUM_PAGES; pg++)\n"
+		"\t{\n"
+		"\t\tbus->pages[pg].attr &= ~PG_CODE;\n"
+		"\t}\n"
+		"\tbus->code_write = NULL;\n"
+		"\tbus->code_ctx = NULL;\n"
+		"\n"
+		"\t*cycles_out += cycles;\n"
+		"\t*count_out += count;\n"
+		"\n"
+		"\t// Not every program uses all of the scratch variables\n"
+		"\t(void)M;\n"
+		"\t(void)zad;\n"
+		"\t(void)addr;\n"
+		"\t(void)base;\n"
+		"\t(void)r;\n"
+		"}\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int c, opt_idx = 0;	// getopt variables
+	word code = DEF_CODE_ADDR;
+	char *code_file = "code.bin";
+	char *c_file = "program.c";
+	FILE *file;
+
+	opterr = 0;
+
+	struct option long_opts[] =
+	{
+		{"version", no_argument, 0, 'v'},
+		{"code-base", required_argument, 0, 'c'},
+		{"program-file", required_argument, 0, 'p'},
+		{"output-file", required_argument, 0, 'o'},
+		{0, 0, 0, 0}
+	};
+
+	while ((c = getopt_long(argc, argv, "vc:p:o:", long_opts, &opt_idx)) != -1)
+		switch (c)
+		{
+			case 'v':
+				printf("em6502rc (6502 recompiler) %.1f\n", VERSION);
+				printf("Copyright (c) %d Brian K. Niece\n", COPYRIGHT);
+				printf("Built %s\n", __DATE__);
+				return 0;
+				break;
+			case 'c':
+				sscanf(optarg, "%hx", &code);
+				break;
+			case 'p':
+				code_file = optarg;
+				break;
+			case 'o':
+				c_file = optarg;
+				break;
+		}
+
+	// Load the program
+	file = fopen(code_file, "rb");
+	if (file == NULL)
+	{
+		printf("Error opening code file: %s\n", code_file);
+		return -1;
+	}
+	image_base = code;
+	image_len = fread(image, sizeof(byte), MAX_MEM - code, file);
+	fclose(file);
+	if (image_len == 0)
+	{
+		printf("Error reading code file: %s\n", code_file);
+		return -1;
+	}
+
+	// Start at the reset vector, which em6502 always points at the code
+	find_code(code);
+
+	file = fopen(c_file, "w");
+	if (file == NULL)
+	{
+		printf("Error opening output file: %s\n", c_file);
+		return -1;
+	}
+	emit_program(file, code_file, code);
+	fclose(file);
+
+	printf("Translated %s at 0x%04x to %s\n", code_file, code, c_file);
+
+	return 0;
+}
@@ -0,0 +1,20 @@
+// recomp.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Programs translated to C by the recompiler (em6502rc)
+//
+// Brian K. Niece
+
+#ifndef RECOMP_H
+#define RECOMP_H
+
+#include "cpu.h"
+
+// Run from cpu->PC until a BRK is executed
+// 	Defined in the C file written by em6502rc, which is only built into
+// 	em6502r.  Cycles used and instructions executed are added to
+// 	*cycles and *count.
+void run_recompiled(CPU *cpu, unsigned long long *cycles,
+		unsigned long long *count);
+
+#endif
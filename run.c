@@ -0,0 +1,456 @@
+// run.c
+//
+// 6502 emulator program
+// 	Bounded runs on the instruction tables
+//
+// Brian K. Niece
+//
+// The loop only keeps one countdown, the number of instructions left
+// 	before the limits are checked again.  The budgets decide how long
+// 	each slice is: no longer than the instruction budget left, and no
+// 	longer than the cycle budget left divided by the most cycles an
+// 	instruction can take, so a slice can't run past either one.
+//
+// The target and watch addresses can't be counted down to, so their
+// 	pages are marked PG_WATCH for the run, along with the watchpoints'.
+// 	Fetching the target or writing the watched address goes through the
+// 	bus hook, which cuts the slice short so the limits are checked before
+// 	the next instruction.  The bus hook and page marks are put back
+// 	afterwards.
+//
+// Samples are taken the same way, the slice is no longer than the
+// 	instructions left until the next one, so they cost nothing in between.
+//
+// The hook can't tell an instruction fetch from an operand read, so an
+// 	execution watchpoint only asks for a check, which looks at PC the
+// 	same as for the target.  A read watchpoint counts its hits instead.
+// 	Fetching the instruction about to run is one hit in its range, so
+// 	when that is the only one the stop waits until after the instruction.
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "run.h"
+#include "membus.h"
+
+// Most cycles any instruction takes (BRK and the indexed shifts)
+#define MAX_OP_CYCLES 7
+
+// Longest slice when nothing limits it
+#define MAX_SLICE 0x40000000
+
+typedef struct run_state
+{
+	const run_limits *limits;
+	CPU *cpu;
+	unsigned long slice;	// instructions in the current slice
+	unsigned long left;	// fetches left until the next check
+	int watched;			// the watched address was written
+	int hit;					// reads and writes that want to stop
+	int fetch_hit;			// stop after the instruction about to run
+	int exec_check;		// read from an execution watchpoint, check PC
+	unsigned long long count;	// instructions before the current slice
+	unsigned long long next_sample;	// count to take the next sample at
+	unsigned long long sampled;		// cycles used at the last sample
+} run_state;
+
+static const char *reasons[] =
+{
+	"BRK",
+	"cycle budget used up",
+	"instruction budget used up",
+	"reached target address",
+	"watched address set",
+	"hit a watchpoint",
+	"target or watch address out of range, or sample_every is 0"
+};
+
+void no_limits(run_limits *limits)
+{
+	limits->cycles = 0;
+	limits->instructions = 0;
+	limits->target = -1;
+	limits->watch = -1;
+	limits->watch_value = 0;
+	limits->watchpoints = NULL;
+	limits->trace = NULL;
+	limits->sample = NULL;
+	limits->sample_every = 0;
+	limits->watch_log = NULL;
+	limits->trace_ctx = NULL;
+}
+
+void add_watchpoint(run_limits *limits, word begin, word end, int type,
+		int stop)
+{
+	watchpoint *wp = malloc(sizeof(watchpoint));
+
+	wp->begin = begin;
+	wp->end = end;
+	wp->type = type;
+	wp->stop = stop;
+	wp->next = limits->watchpoints;
+	limits->watchpoints = wp;
+}
+
+void free_watchpoints(run_limits *limits)
+{
+	while (limits->watchpoints != NULL)
+	{
+		watchpoint *wp = limits->watchpoints;
+		limits->watchpoints = wp->next;
+		free(wp);
+	}
+}
+
+const char *run_reason(int reason)
+{
+	return reasons[reason];
+}
+
+static void run_watch(void *watch_ctx, word addr, int write)
+// Bus hook for the target, watch and watchpoint pages
+// 	Ends the slice after the instruction running now.  The instructions
+// 	in the slice so far become the whole slice, so they are counted the
+// 	same as when the countdown runs out.
+{
+	run_state *rs = watch_ctx;
+	const run_limits *limits = rs->limits;
+	int type = write ? WATCH_WRITE : WATCH_READ;
+	int logged = 0;
+	int stop = 0;
+	int cut = 0;
+
+	if (write ? (addr == limits->watch) : (addr == limits->target))
+	{
+		if (write)
+		{
+			rs->watched = 1;
+		}
+		cut = 1;
+	}
+
+	for (watchpoint *wp = limits->watchpoints; wp != NULL; wp = wp->next)
+	{
+		if ((addr < wp->begin) || (addr > wp->end))
+		{
+			continue;
+		}
+		if ((wp->type & type) != 0)
+		{
+			if ((limits->watch_log != NULL) && (logged == 0))
+			{
+				limits->watch_log(limits->trace_ctx, rs->cpu, addr, type);
+				logged = 1;
+			}
+			if (wp->stop != 0)
+			{
+				stop = 1;
+				cut = 1;
+			}
+		}
+		if (((wp->type & WATCH_EXEC) != 0) && (write == 0))
+		{
+			rs->exec_check = 1;
+			cut = 1;
+		}
+	}
+
+	rs->hit += stop;
+
+	if (cut != 0)
+	{
+		rs->slice -= rs->left - 1;
+		rs->left = 1;
+	}
+}
+
+static int exec_watch(CPU *cpu, run_state *rs)
+// Log and look for a stop at the instruction about to execute
+// 	returns 1 to stop
+{
+	const run_limits *limits = rs->limits;
+	int logged = 0;
+	int stop = 0;
+
+	for (watchpoint *wp = limits->watchpoints; wp != NULL; wp = wp->next)
+	{
+		if (((wp->type & WATCH_EXEC) == 0) || (cpu->PC < wp->begin) ||
+				(cpu->PC > wp->end))
+		{
+			continue;
+		}
+		if ((limits->watch_log != NULL) && (logged == 0))
+		{
+			limits->watch_log(limits->trace_ctx, cpu, cpu->PC, WATCH_EXEC);
+			logged = 1;
+		}
+		stop |= wp->stop;
+	}
+
+	// Same as the target, a run can start on a watchpoint
+	return (stop != 0) && (rs->count > 0);
+}
+
+static int read_stop(const run_limits *limits, word addr)
+// returns 1 if a read of addr hits a watchpoint set to stop
+{
+	for (watchpoint *wp = limits->watchpoints; wp != NULL; wp = wp->next)
+	{
+		if (((wp->type & WATCH_READ) != 0) && (wp->stop != 0) &&
+				(addr >= wp->begin) && (addr <= wp->end))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int check_limits(CPU *cpu, run_state *rs, unsigned long long cycles)
+// Count the slice just finished and start another, or stop
+// 	returns -1 to carry on, or the RUN_ reason for stopping
+{
+	const run_limits *limits = rs->limits;
+	unsigned long slice = MAX_SLICE;
+	mem_page *page;
+
+	rs->count += rs->slice;
+
+	if (rs->watched != 0)
+	{
+		rs->watched = 0;
+		page = &cpu->bus->pages[limits->watch >> 8];
+		if (page->host[limits->watch & 0xFF] == limits->watch_value)
+		{
+			return RUN_WATCH;
+		}
+	}
+
+	if (rs->fetch_hit != 0)
+	{
+		rs->fetch_hit = 0;
+		rs->hit = 0;
+		return RUN_WATCHPOINT;
+	}
+
+	// A lone hit where PC is was fetching the instruction about to run,
+	// 	which stops after it
+	if (rs->hit != 0)
+	{
+		if ((rs->hit == 1) && (read_stop(limits, cpu->PC) != 0))
+		{
+			rs->fetch_hit = 1;
+		}
+		rs->hit = 0;
+		if (rs->fetch_hit == 0)
+		{
+			return RUN_WATCHPOINT;
+		}
+	}
+
+	// Only after the first instruction, so a run can start at the target
+	if ((cpu->PC == limits->target) && (rs->count > 0))
+	{
+		return RUN_TARGET;
+	}
+
+	if (limits->cycles != 0)
+	{
+		if (cycles >= limits->cycles)
+		{
+			return RUN_CYCLES;
+		}
+		if ((limits->cycles - cycles) / MAX_OP_CYCLES < slice)
+		{
+			slice = (unsigned long)((limits->cycles - cycles) / MAX_OP_CYCLES);
+		}
+
+		// The last few cycles are checked one instruction at a time
+		if (slice == 0)
+		{
+			slice = 1;
+		}
+	}
+
+	if (limits->instructions != 0)
+	{
+		if (rs->count >= limits->instructions)
+		{
+			return RUN_INSTRUCTIONS;
+		}
+		if (limits->instructions - rs->count < slice)
+		{
+			slice = (unsigned long)(limits->instructions - rs->count);
+		}
+	}
+
+	if (limits->sample != NULL)
+	{
+		if (rs->count >= rs->next_sample)
+		{
+			limits->sample(limits->trace_ctx, cpu, cycles - rs->sampled);
+			rs->sampled = cycles;
+			rs->next_sample = rs->count + limits->sample_every;
+		}
+		if (rs->next_sample - rs->count < slice)
+		{
+			slice = (unsigned long)(rs->next_sample - rs->count);
+		}
+	}
+
+	// Last, so an instruction is only logged when it will execute
+	if (rs->exec_check != 0)
+	{
+		rs->exec_check = 0;
+		if (exec_watch(cpu, rs) != 0)
+		{
+			return RUN_WATCHPOINT;
+		}
+	}
+
+	// Only it, if its fetch hit
+	if (rs->fetch_hit != 0)
+	{
+		slice = 1;
+	}
+
+	// The instruction being fetched now is the first of the slice
+	rs->slice = slice;
+	rs->left = slice;
+	return -1;
+}
+
+static inline int run_loop(CPU *cpu, run_state *rs, unsigned long long *cycles,
+		const int traced)
+// Fetch, check and execute until a stop
+// 	traced is a constant at each call, so the trace call drops out of
+// 	the untraced loop.
+{
+	const run_limits *limits = rs->limits;
+	membus *bus = cpu->bus;
+	unsigned long long used = 0;
+	struct opreturn opr;
+	word addr;
+	int reason;
+
+	for (;;)
+	{
+		addr = cpu->PC;
+		cpu->IR = read(bus, addr);
+
+		// The one check on every instruction
+		if (--rs->left == 0)
+		{
+			reason = check_limits(cpu, rs, used);
+			if (reason >= 0)
+			{
+				break;
+			}
+		}
+
+		// D picks the binary or decimal instruction table
+		opr = cpu->optable[(cpu->SR & D) != 0][cpu->IR](cpu);
+		used += opr.cycles;
+
+		if (traced)
+		{
+			limits->trace(limits->trace_ctx, cpu, addr, opr);
+		}
+
+		if (cpu->IR == 0x00)
+		{
+			rs->count += rs->slice - (rs->left - 1);
+			reason = RUN_BRK;
+			break;
+		}
+	}
+
+	*cycles += used;
+	return reason;
+}
+
+int run(CPU *cpu, const run_limits *limits, unsigned long long *cycles,
+		unsigned long long *count)
+{
+	membus *bus = cpu->bus;
+	run_state rs;
+	int reason;
+
+	// Previous bus hook and page marks, put back at the end
+	void (*old_watch)(void *, word, int) = bus->watch;
+	void *old_watch_ctx = bus->watch_ctx;
+	byte was_watched[NUM_PAGES];
+	int watching = (limits->target >= 0) || (limits->watch >= 0) ||
+		(limits->watchpoints != NULL);
+
+	// Their pages are marked below, so they have to be in the page table
+	// 	A sample every 0 instructions would be a slice of none
+	if ((limits->target >= MAX_MEM) || (limits->watch >= MAX_MEM) ||
+			((limits->sample != NULL) && (limits->sample_every == 0)))
+	{
+		return RUN_BAD_LIMITS;
+	}
+
+	rs.limits = limits;
+	rs.cpu = cpu;
+	rs.slice = 0;
+	rs.left = 1;			// check before the first instruction
+	rs.watched = 0;
+	rs.hit = 0;
+	rs.fetch_hit = 0;
+	rs.exec_check = 0;
+	rs.count = 0;
+	rs.next_sample = limits->sample_every;
+	rs.sampled = 0;
+
+	if (watching)
+	{
+		bus->watch = run_watch;
+		bus->watch_ctx = &rs;
+
+		for (int pg = 0; pg < NUM_PAGES; pg++)
+		{
+			was_watched[pg] = bus->pages[pg].attr & PG_WATCH;
+		}
+		if (limits->target >= 0)
+		{
+			bus->pages[limits->target >> 8].attr |= PG_WATCH;
+		}
+		if (limits->watch >= 0)
+		{
+			bus->pages[limits->watch >> 8].attr |= PG_WATCH;
+		}
+		for (watchpoint *wp = limits->watchpoints; wp != NULL; wp = wp->next)
+		{
+			for (int pg = wp->begin >> 8; pg <= wp->end >> 8; pg++)
+			{
+				bus->pages[pg].attr |= PG_WATCH;
+			}
+		}
+	}
+
+	if (limits->trace != NULL)
+	{
+		reason = run_loop(cpu, &rs, cycles, 1);
+	}
+	else
+	{
+		reason = run_loop(cpu, &rs, cycles, 0);
+	}
+
+	// Only PG_WATCH, the first write to a PG_CLEAN page changes the rest
+	if (watching)
+	{
+		for (int pg = 0; pg < NUM_PAGES; pg++)
+		{
+			bus->pages[pg].attr = (bus->pages[pg].attr & ~PG_WATCH) |
+				was_watched[pg];
+		}
+	}
+	bus->watch = old_watch;
+	bus->watch_ctx = old_watch_ctx;
+
+	*count += rs.count;
+	return reason;
+}
@@ -0,0 +1,89 @@
+// run.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Bounded runs on the instruction tables
+//
+// Brian K. Niece
+
+#ifndef RUN_H
+#define RUN_H
+
+#include "cpu.h"
+#include "instructions.h"
+
+// Why run() stopped
+#define RUN_BRK 0				// executed a BRK
+#define RUN_CYCLES 1			// used up the cycle budget
+#define RUN_INSTRUCTIONS 2	// used up the instruction budget
+#define RUN_TARGET 3			// PC reached the target address
+#define RUN_WATCH 4			// the watched address was set to the watched value
+#define RUN_WATCHPOINT 5	// hit a watchpoint set to stop
+#define RUN_BAD_LIMITS 6	// target or watch address outside memory, or
+							// samples every 0 instructions, not run
+
+// Watchpoint types, can be or'ed together
+#define WATCH_READ 1			// any read, including instruction fetches
+#define WATCH_WRITE 2
+#define WATCH_EXEC 4			// an instruction starting in the range
+
+// Watched range of addresses, begin to end inclusive
+// 	Reads and writes stop after the instruction, execution stops before.
+typedef struct watchpoint
+{
+	word begin;
+	word end;
+	int type;					// WATCH_ bits
+	int stop;					// 1 to stop the run, 0 to only log
+	struct watchpoint *next;
+} watchpoint;
+
+// Called after each instruction when tracing, addr is where it started
+typedef void (*run_trace)(void *trace_ctx, CPU *cpu, word addr,
+		struct opreturn opr);
+
+// Called every sample_every instructions when sampling, before the next
+// 	instruction, with the cycles used since the last sample
+typedef void (*run_sample)(void *trace_ctx, CPU *cpu,
+		unsigned long long cycles);
+
+// Called for each watched access, type is one WATCH_ bit
+typedef void (*run_watch_log)(void *trace_ctx, CPU *cpu, word addr, int type);
+
+// Limits on a run
+// 	Budgets count from the start of the run, 0 means no limit.
+// 	Addresses are -1 for none, or 0 to 0xFFFF.
+typedef struct run_limits
+{
+	unsigned long long cycles;			// stop once this many cycles are used
+	unsigned long long instructions;	// stop after this many instructions
+	int target;							// stop before executing this address
+	int watch;							// stop after a write of watch_value here
+	byte watch_value;
+	watchpoint *watchpoints;		// NULL for none
+
+	run_trace trace;					// NULL for no trace
+	run_sample sample;				// NULL for no samples
+	unsigned long long sample_every;	// instructions between samples, not 0
+	run_watch_log watch_log;		// NULL to not log watchpoints
+	void *trace_ctx;					// passed to trace, sample and watch_log
+} run_limits;
+
+// Set every limit off
+void no_limits(run_limits *limits);
+
+// Watchpoints only mark the pages they are in, the rest of memory
+// 	stays on the fast path
+void add_watchpoint(run_limits *limits, word begin, word end, int type,
+		int stop);
+void free_watchpoints(run_limits *limits);
+
+// Text for a RUN_ reason
+const char *run_reason(int reason);
+
+// Run from cpu->PC on the instruction tables until a BRK or a limit
+// 	Cycles used and instructions executed are added to *cycles and *count
+int run(CPU *cpu, const run_limits *limits, unsigned long long *cycles,
+		unsigned long long *count);
+	// returns the RUN_ reason for stopping
+
+#endif
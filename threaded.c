@@ -0,0 +1,100 @@
+// threaded.c
+//
+// 6502 emulator program
+// 	Threaded-code interpreter core
+//
+// Brian K. Niece
+//
+// This is a second execution engine that gives the same results as the
+// 	handlers in instructions.c, but without the function call per
+// 	instruction.  The handler bodies (opbodies.h) are inlined in
+// 	run_threaded() and end by jumping straight to the label of the next
+// 	opcode (computed goto, a GCC/Clang extension).  Compilers without
+// 	labels as values get the same bodies in a switch statement instead.
+//
+// The registers are kept in local variables while running and copied
+// 	back to the CPU when BRK ends the program.  No opreturn is built, so
+// 	the code log is not available from this engine.
+
+#include "threaded.h"
+#include "membus.h"
+#include "opcore.h"
+
+// Operands follow the opcode at PC
+#define OPR8		RD(PC + 1)
+#define OPR16		(RD(PC + 1) + (RD(PC + 2) << 8))
+#define WR(a, v)	write(bus, (word)(a), (v))
+
+// Move on to the next instruction
+#define NEXT(bytes, cyc)	PC += (bytes); cycles += (cyc); DISPATCH()
+
+#ifdef THREADED_GOTO
+#define OPCODE(op)	op_##op:
+#define UNDEFINED
+#define DISPATCH()	count++; goto *dispatch[IR = RD(PC)]
+#else
+#define OPCODE(op)	case 0x##op:
+#define UNDEFINED	default:
+#define DISPATCH()	continue
+#endif
+
+void run_threaded(CPU *cpu, unsigned long long *cycles_out,
+		unsigned long long *count_out)
+{
+	membus *bus = cpu->bus;
+
+	// Working copies of the registers
+	word PC = cpu->PC;
+	byte SP = cpu->SP;
+	byte A = cpu->A;
+	byte X = cpu->X;
+	byte Y = cpu->Y;
+	byte SR = get_SR(cpu);
+	byte IR;
+
+	// Scratch used by the handler bodies
+	byte M, zad;
+	word addr, base;
+	int r;
+
+	unsigned long long cycles = 0;
+	unsigned long long count = 0;
+
+#ifdef THREADED_GOTO
+	static const void *dispatch[256] = { OPCODE_LABELS };
+
+	DISPATCH();
+#else
+	for (;;)
+	{
+		count++;
+		IR = RD(PC);
+		switch (IR)
+		{
+#endif
+
+#include "opbodies.h"
+
+	OPCODE(00)
+		// BRK ends the program, as in do_BRK_impl
+		PC++;
+		cycles += 7;
+		goto done;
+
+#ifndef THREADED_GOTO
+		}
+	}
+#endif
+
+done:
+	cpu->PC = PC;
+	cpu->SP = SP;
+	cpu->A = A;
+	cpu->X = X;
+	cpu->Y = Y;
+	cpu->SR = SR;
+	cpu->IR = IR;
+
+	*cycles_out += cycles;
+	*count_out += count;
+}
@@ -0,0 +1,18 @@
+// threaded.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Threaded-code interpreter core
+//
+// Brian K. Niece
+
+#ifndef THREADED_H
+#define THREADED_H
+
+#include "cpu.h"
+
+// Run from cpu->PC until a BRK is executed
+// 	Cycles used and instructions executed are added to *cycles and *count
+void run_threaded(CPU *cpu, unsigned long long *cycles,
+		unsigned long long *count);
+
+#endif
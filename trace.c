@@ -0,0 +1,666 @@
+// trace.c
+//
+// 6502 emulator program
+// 	Binary execution trace
+//
+// Brian K. Niece
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "trace.h"
+#include "cpu.h"
+#include "instructions.h"
+
+// Delta coder state
+// 	The decoder keeps the same state to make the same predictions
+typedef struct trace_pc
+{
+	int seen;					// chunk this PC last ran in
+	int succ_seen;				// chunk succ was set in
+	word succ;					// PC that followed it
+	word operand;				// and what it did
+	byte op;
+	byte result;
+	byte sr;
+	byte cycles;
+} trace_pc;
+
+struct trace_coder
+{
+	byte *chunk;				// keyframe then coded records, for one write
+	trace_keyframe key;		// chunk being coded
+	int stamp;					// chunk number, for seen and succ_seen
+	trace_pc *pcs;				// MAX_MEM of them
+	long last_pc;				// -1 after a keyframe
+};
+
+// Longest coded record, tag, PC, SR, opcode, operand, result and cycles
+#define TD_MAX 9
+
+static struct trace_coder *new_coder()
+{
+	struct trace_coder *c = calloc(1, sizeof(struct trace_coder));
+
+	if (c == NULL)
+	{
+		return NULL;
+	}
+	c->chunk = malloc(sizeof(trace_keyframe) + TRACE_KEYFRAME * TD_MAX);
+	c->pcs = calloc(MAX_MEM, sizeof(trace_pc));
+	if ((c->chunk == NULL) || (c->pcs == NULL))
+	{
+		free(c->chunk);
+		free(c->pcs);
+		free(c);
+		return NULL;
+	}
+	c->stamp = 1;
+	c->last_pc = -1;
+
+	return c;
+}
+
+static void free_coder(struct trace_coder *c)
+{
+	free(c->chunk);
+	free(c->pcs);
+	free(c);
+}
+
+static long predict_pc(struct trace_coder *c)
+// returns the PC expected next, -1 after a keyframe
+{
+	trace_pc *last;
+
+	if (c->last_pc < 0)
+	{
+		return -1;
+	}
+	last = &c->pcs[c->last_pc];
+	if (last->succ_seen == c->stamp)
+	{
+		return last->succ;
+	}
+	return (c->last_pc + op_length[last->op]) & 0xFFFF;
+}
+
+static void learn(struct trace_coder *c, trace_record *rec)
+// Remember a record for the next predictions
+{
+	trace_pc *pc = &c->pcs[rec->pc];
+
+	if (c->last_pc >= 0)
+	{
+		c->pcs[c->last_pc].succ = rec->pc;
+		c->pcs[c->last_pc].succ_seen = c->stamp;
+	}
+	c->last_pc = rec->pc;
+
+	pc->seen = c->stamp;
+	pc->operand = rec->operand;
+	pc->op = rec->op;
+	pc->result = rec->result;
+	pc->sr = rec->sr;
+	pc->cycles = rec->size & 0x0F;
+}
+
+static void finish_chunk(trace_file *t)
+// Write the chunk with its keyframe, and start the next one
+{
+	struct trace_coder *c = t->coder;
+	size_t len = sizeof(trace_keyframe) + c->key.length;
+
+	if (c->key.records == 0)
+	{
+		return;
+	}
+
+	memcpy(c->chunk, &c->key, sizeof(trace_keyframe));
+	if ((t->error == 0) && (fwrite(c->chunk, 1, len, t->file) != len))
+	{
+		t->error = 1;
+	}
+
+	// Nothing carries over a keyframe
+	c->key.first_record += c->key.records;
+	c->key.first_cycle += c->key.cycles;
+	c->key.length = 0;
+	c->key.records = 0;
+	c->key.cycles = 0;
+	c->stamp++;
+	c->last_pc = -1;
+}
+
+static void end_record(trace_file *t, byte *p)
+// The coded record ends at p, finish the chunk if that fills it
+{
+	struct trace_coder *c = t->coder;
+
+	c->key.length = p - (c->chunk + sizeof(trace_keyframe));
+	c->key.records++;
+	if (c->key.records == TRACE_KEYFRAME)
+	{
+		finish_chunk(t);
+	}
+}
+
+static void code_gap(trace_file *t, trace_record *rec)
+// A gap isn't an instruction, so it is neither predicted nor learned
+{
+	struct trace_coder *c = t->coder;
+	byte *p = c->chunk + sizeof(trace_keyframe) + c->key.length;
+
+	*p++ = TD_GAP;
+	*p++ = rec->pc & 0xFF;
+	*p++ = rec->pc >> 8;
+	*p++ = rec->operand & 0xFF;
+	*p++ = rec->operand >> 8;
+	c->key.cycles += gap_cycles(rec);
+	end_record(t, p);
+}
+
+static void code_record(trace_file *t, trace_record *rec)
+// Add a record to the chunk, leaving out what the decoder can predict
+{
+	struct trace_coder *c = t->coder;
+	byte *p = c->chunk + sizeof(trace_keyframe) + c->key.length;
+	byte *tag = p++;
+	trace_pc *pc = &c->pcs[rec->pc];
+	int known = (pc->seen == c->stamp);
+
+	if (trace_gap(rec))
+	{
+		code_gap(t, rec);
+		return;
+	}
+
+	*tag = 0;
+	if (rec->pc != predict_pc(c))
+	{
+		*tag |= TD_PC;
+		*p++ = rec->pc & 0xFF;
+		*p++ = rec->pc >> 8;
+	}
+	if (!known || (pc->sr != rec->sr))
+	{
+		*tag |= TD_SR;
+		*p++ = rec->sr;
+	}
+	if (!known || (pc->op != rec->op))
+	{
+		*tag |= TD_OP;
+		*p++ = rec->op;
+	}
+	if (!known || (pc->operand != rec->operand))
+	{
+		*tag |= TD_OPERAND;
+		*p++ = rec->operand & 0xFF;
+		*p++ = rec->operand >> 8;
+	}
+	if (!known || (pc->result != rec->result))
+	{
+		*tag |= TD_RESULT;
+		*p++ = rec->result;
+	}
+	if (!known || (pc->cycles != (rec->size & 0x0F)))
+	{
+		*tag |= TD_CYCLES;
+		*p++ = rec->size & 0x0F;
+	}
+	learn(c, rec);
+	c->key.cycles += rec->size & 0x0F;
+	end_record(t, p);
+}
+
+static int write_records(trace_file *t, unsigned long from, unsigned long to)
+// Write the records from index from up to to, in one piece, or two where
+// 	they wrap around the end of the ring
+{
+	unsigned long first = from & (TRACE_RING - 1);
+	unsigned long n = to - from;
+	unsigned long part = (first + n > TRACE_RING) ? TRACE_RING - first : n;
+
+	// Delta coded records go out a chunk at a time
+	if (t->coder != NULL)
+	{
+		for (; from != to; from++)
+		{
+			code_record(t, &t->buf[from & (TRACE_RING - 1)]);
+		}
+		return (t->error == 0) ? 0 : -3;
+	}
+
+	if ((fwrite(&t->buf[first], sizeof(trace_record), part, t->file) != part) ||
+			(fwrite(t->buf, sizeof(trace_record), n - part, t->file) != n - part))
+	{
+		t->error = 1;
+		return -3;
+	}
+
+	return 0;
+}
+
+#ifdef TRACE_THREAD
+static void pause_briefly()
+// Long enough to let the other side get on, much less than a write
+{
+	struct timespec ts = { 0, 100000 };
+
+	nanosleep(&ts, NULL);
+}
+
+static void *trace_writer(void *arg)
+// Write out what the emulator publishes until it is done
+{
+	trace_file *t = arg;
+	unsigned long tail = 0, pub;
+	int done;
+
+	for (;;)
+	{
+		// Done is read first, so nothing published before it is missed
+		done = atomic_load_explicit(&t->done, memory_order_acquire);
+		pub = atomic_load_explicit(&t->published, memory_order_acquire);
+
+		if (pub == tail)
+		{
+			if (done)
+			{
+				break;
+			}
+			pause_briefly();
+			continue;
+		}
+
+		// After a write error, keep taking records so the emulator never
+		// 	waits on a writer that has given up
+		if (t->error == 0)
+		{
+			write_records(t, tail, pub);
+		}
+		tail = pub;
+		atomic_store_explicit(&t->tail, tail, memory_order_release);
+	}
+
+	if (t->coder != NULL)
+	{
+		finish_chunk(t);
+	}
+
+	return NULL;
+}
+#endif
+
+int open_trace(char *filename, trace_file *t, int mode, int format)
+// Create the file, write the header and start the writer
+// 	The file is unbuffered, so whatever the writer takes from the ring
+// 	goes out in a single write.  (Not unistd.h, its write() would clash
+// 	with the bus.)
+{
+	trace_header head;
+
+	t->file = fopen(filename, "wb");
+	if (t->file == NULL)
+	{
+		return -1;
+	}
+	setvbuf(t->file, NULL, _IONBF, 0);
+
+	t->buf = malloc(TRACE_RING * sizeof(trace_record));
+	if (t->buf == NULL)
+	{
+		fclose(t->file);
+		return -2;
+	}
+	t->mode = mode;
+	t->coder = NULL;
+	if (format == TRACE_DELTA)
+	{
+		t->coder = new_coder();
+		if (t->coder == NULL)
+		{
+			fclose(t->file);
+			free(t->buf);
+			return -2;
+		}
+	}
+	t->head = 0;
+	t->tail_seen = 0;
+	t->dropped = 0;
+	t->stalls = 0;
+	t->skipped = 0;
+	t->error = 0;
+
+	memcpy(head.magic, TRACE_MAGIC, 4);
+	head.version = (format == TRACE_DELTA) ? TRACE_DELTA_VERSION : TRACE_VERSION;
+	head.record_size = sizeof(trace_record);
+	if (fwrite(&head, sizeof(head), 1, t->file) != 1)
+	{
+		fclose(t->file);
+		free(t->buf);
+		if (t->coder != NULL)
+		{
+			free_coder(t->coder);
+		}
+		return -3;
+	}
+
+#ifdef TRACE_THREAD
+	atomic_init(&t->published, 0);
+	atomic_init(&t->tail, 0);
+	atomic_init(&t->done, 0);
+	if (pthread_create(&t->writer, NULL, trace_writer, t) != 0)
+	{
+		fclose(t->file);
+		free(t->buf);
+		if (t->coder != NULL)
+		{
+			free_coder(t->coder);
+		}
+		return -2;
+	}
+#endif
+
+	return 0;
+}
+
+int trace_full(trace_file *t)
+// The ring was full when the emulator last looked
+{
+#ifdef TRACE_THREAD
+	// The writer may have moved on since
+	t->tail_seen = atomic_load_explicit(&t->tail, memory_order_acquire);
+	if (t->head - t->tail_seen < TRACE_RING)
+	{
+		return 0;
+	}
+
+	// It can only catch up on what it has been told about
+	atomic_store_explicit(&t->published, t->head, memory_order_release);
+
+	if (t->mode == TRACE_DROP)
+	{
+		t->dropped++;
+		return -1;
+	}
+
+	t->stalls++;
+	while (t->head - t->tail_seen == TRACE_RING)
+	{
+		pause_briefly();
+		t->tail_seen = atomic_load_explicit(&t->tail, memory_order_acquire);
+	}
+#else
+	// Without a writer, write the whole ring out now
+	if (t->error == 0)
+	{
+		write_records(t, t->tail_seen, t->head);
+	}
+	t->tail_seen = t->head;
+#endif
+
+	return 0;
+}
+
+int close_trace(trace_file *t)
+{
+#ifdef TRACE_THREAD
+	atomic_store_explicit(&t->published, t->head, memory_order_release);
+	atomic_store_explicit(&t->done, 1, memory_order_release);
+	pthread_join(t->writer, NULL);
+#else
+	if (t->error == 0)
+	{
+		write_records(t, t->tail_seen, t->head);
+	}
+	if (t->coder != NULL)
+	{
+		finish_chunk(t);
+	}
+#endif
+
+	fclose(t->file);
+	free(t->buf);
+	t->buf = NULL;
+	if (t->coder != NULL)
+	{
+		free_coder(t->coder);
+		t->coder = NULL;
+	}
+
+	return (t->error == 0) ? 0 : -3;
+}
+
+// Opcodes in each OPS_ group
+static const byte ops_branch[] =
+{
+	0x10, 0x30, 0x50, 0x70, 0x90, 0xB0, 0xD0, 0xF0,	// Bcc rel
+	0x4C, 0x6C, 0x20, 0x60, 0x40, 0x00					// JMP, JSR, RTS, RTI, BRK
+};
+static const byte ops_stack[] =
+{
+	0x48, 0x08, 0x68, 0x28,					// PHA, PHP, PLA, PLP
+	0x20, 0x60, 0x40, 0x00,					// JSR, RTS, RTI, BRK
+	0x9A, 0xBA									// TXS, TSX
+};
+static const byte ops_write[] =
+{
+	0x81, 0x85, 0x8D, 0x91, 0x95, 0x99, 0x9D,	// STA
+	0x86, 0x8E, 0x96, 0x84, 0x8C, 0x94,			// STX, STY
+	0x06, 0x0E, 0x16, 0x1E, 0x46, 0x4E, 0x56, 0x5E,	// ASL, LSR
+	0x26, 0x2E, 0x36, 0x3E, 0x66, 0x6E, 0x76, 0x7E,	// ROL, ROR
+	0xE6, 0xEE, 0xF6, 0xFE, 0xC6, 0xCE, 0xD6, 0xDE	// INC, DEC
+};
+
+void init_filter(trace_filter *f)
+{
+	memset(f->pc, 0xFF, sizeof(f->pc));
+	memset(f->op, 0xFF, sizeof(f->op));
+	f->pc_ranges = 0;
+	f->op_groups = 0;
+	f->start = 0;
+	f->stop = ~0ULL;
+	f->cycle = 0;
+}
+
+void filter_pc(trace_filter *f, word begin, word end)
+{
+	// The first range replaces every address
+	if (f->pc_ranges++ == 0)
+	{
+		memset(f->pc, 0, sizeof(f->pc));
+	}
+
+	for (long a = begin; a <= end; a++)
+	{
+		f->pc[a >> 3] |= 1 << (a & 7);
+	}
+}
+
+static void set_ops(trace_filter *f, const byte *ops, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		f->op[ops[i] >> 3] |= 1 << (ops[i] & 7);
+	}
+}
+
+void filter_ops(trace_filter *f, int groups)
+{
+	// The first group replaces every opcode
+	if (f->op_groups == 0)
+	{
+		memset(f->op, 0, sizeof(f->op));
+	}
+	f->op_groups |= groups;
+
+	if (groups & OPS_BRANCH)
+	{
+		set_ops(f, ops_branch, sizeof(ops_branch));
+	}
+	if (groups & OPS_STACK)
+	{
+		set_ops(f, ops_stack, sizeof(ops_stack));
+	}
+	if (groups & OPS_WRITE)
+	{
+		set_ops(f, ops_write, sizeof(ops_write));
+	}
+}
+
+int op_group(char *name)
+{
+	if (strcmp(name, "branch") == 0)
+	{
+		return OPS_BRANCH;
+	}
+	if (strcmp(name, "stack") == 0)
+	{
+		return OPS_STACK;
+	}
+	if (strcmp(name, "write") == 0)
+	{
+		return OPS_WRITE;
+	}
+	return 0;
+}
+
+void filter_cycles(trace_filter *f, unsigned long long start,
+		unsigned long long stop)
+{
+	f->start = start;
+	f->stop = (stop == 0) ? ~0ULL : stop;
+}
+
+void print_record(FILE *out, trace_record *rec, const char *mnemonic)
+// One line of the code log
+// 	Built up in a buffer, so there is one call to stdio per instruction
+{
+	char line[128];
+	int bytes = rec->size >> 4;
+	int cycles = rec->size & 0x0F;
+	int len, i;
+
+	len = sprintf(line, "0x%04X %-9s (%d %s", rec->pc, mnemonic, bytes,
+		(bytes == 1) ? "byte)  " : "bytes) ");
+
+	// A dot for each cycle, padded out to 8
+	for (i = 0; i < 8; i++)
+	{
+		line[len++] = ' ';
+		line[len++] = (i < cycles) ? '.' : ' ';
+	}
+
+	if (bytes == 1)
+	{
+		len += sprintf(line + len, "       0x%02X", rec->result);
+	}
+	else if (rec->operand <= 0xFF)
+	{
+		len += sprintf(line + len, "  0x%02X 0x%02X", rec->operand, rec->result);
+	}
+	else
+	{
+		len += sprintf(line + len, "0x%04X 0x%02X", rec->operand, rec->result);
+	}
+
+	sprintf(line + len, " %c%c%c%c%c%c%c%c\n", rec->sr & N ? 'N' : '.',
+			rec->sr & V ? 'V' : '.', '.', rec->sr & B ? 'B' : '.',
+			rec->sr & D ? 'D' : '.', rec->sr & I ? 'I' : '.',
+			rec->sr & Z ? 'Z' : '.', rec->sr & C ? 'C' : '.');
+
+	fputs(line, out);
+}
+
+int decode_chunk(byte *data, trace_keyframe *key, trace_record *recs)
+// Make the coder's predictions again to fill in what was left out
+{
+	struct trace_coder *c = new_coder();
+	byte *p = data, *end = data + key->length;
+	trace_record *rec;
+	trace_pc *pc;
+	long next_pc;
+	int need, cycles;
+	unsigned int i;
+	byte tag;
+
+	if (c == NULL)
+	{
+		return -2;
+	}
+
+	for (i = 0; i < key->records; i++)
+	{
+		rec = &recs[i];
+
+		// Make sure the fields the tag asks for are all there
+		if (p >= end)
+		{
+			break;
+		}
+		tag = *p++;
+		if (tag == TD_GAP)
+		{
+			if (p + 4 > end)
+			{
+				break;
+			}
+			rec->pc = p[0] | (p[1] << 8);
+			rec->operand = p[2] | (p[3] << 8);
+			rec->op = 0;
+			rec->result = 0;
+			rec->sr = 0;
+			rec->size = 0;
+			p += 4;
+			continue;
+		}
+		need = ((tag & TD_PC) ? 2 : 0) + ((tag & TD_SR) ? 1 : 0) +
+			((tag & TD_OP) ? 1 : 0) + ((tag & TD_OPERAND) ? 2 : 0) +
+			((tag & TD_RESULT) ? 1 : 0) + ((tag & TD_CYCLES) ? 1 : 0);
+		if (p + need > end)
+		{
+			break;
+		}
+
+		if (tag & TD_PC)
+		{
+			next_pc = p[0] | (p[1] << 8);
+			p += 2;
+		}
+		else if ((next_pc = predict_pc(c)) < 0)
+		{
+			break;
+		}
+		rec->pc = next_pc;
+
+		// Every field is there the first time a PC runs in a chunk
+		pc = &c->pcs[rec->pc];
+		if ((pc->seen != c->stamp) && ((tag & 0x3E) != 0x3E))
+		{
+			break;
+		}
+
+		rec->sr = (tag & TD_SR) ? *p++ : pc->sr;
+		rec->op = (tag & TD_OP) ? *p++ : pc->op;
+		if (tag & TD_OPERAND)
+		{
+			rec->operand = p[0] | (p[1] << 8);
+			p += 2;
+		}
+		else
+		{
+			rec->operand = pc->operand;
+		}
+		rec->result = (tag & TD_RESULT) ? *p++ : pc->result;
+		cycles = (tag & TD_CYCLES) ? *p++ : pc->cycles;
+		rec->size = (op_length[rec->op] << 4) | (cycles & 0x0F);
+
+		learn(c, rec);
+	}
+
+	free_coder(c);
+	return ((i == key->records) && (p == end)) ? 0 : -2;
+}
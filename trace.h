@@ -0,0 +1,288 @@
+// trace.h
+//
+// Definitions and function prototypes for 6502 emulator program
+// 	Binary execution trace
+//
+// Brian K. Niece
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+#include "membus.h"
+
+// A trace file is a header followed by a record for each instruction, in
+// 	host byte order.  em6502td turns one back into the code log.
+#define TRACE_MAGIC "6502"
+#define TRACE_VERSION 1			// fixed size records
+#define TRACE_DELTA_VERSION 2	// delta coded chunks
+
+// Trace formats
+#define TRACE_RAW 0				// a trace_record for each instruction
+#define TRACE_DELTA 1			// delta coded, see below
+
+// A writer thread drains the records to the file where there is one
+// 	Not on Windows, where the buffer is written out each time it fills
+#if !defined(_WIN32)
+#define TRACE_THREAD
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+// Records in the ring buffer, a power of 2
+#define TRACE_RING (1 << 20)
+
+// Records added before the writer is told about them, a power of 2
+// 	Telling it about each one would bounce the cache line between them
+#define TRACE_BATCH 4096
+
+// What to do when the writer falls behind and the ring is full
+#define TRACE_BLOCK 0		// wait for it
+#define TRACE_DROP 1			// drop the record, and count it
+
+typedef struct trace_header
+{
+	char magic[4];			// TRACE_MAGIC
+	word version;			// TRACE_VERSION
+	word record_size;		// sizeof(trace_record)
+} trace_header;
+
+typedef struct trace_record
+{
+	word pc;					// where the instruction started
+	word operand;
+	byte op;
+	byte result;
+	byte sr;					// status after the instruction
+	byte size;				// bytes in the high nibble, cycles in the low
+} trace_record;
+
+// Instructions left out by a filter still count towards the cycles
+// 	A gap record before the next one traced holds their cycles, pc the
+// 	low 16 bits and operand the high 16.  It is told apart by 0 in the
+// 	bytes nibble of size, which no instruction has.
+#define TRACE_GAP_MAX 0xFFFFFFFFUL
+
+static inline int trace_gap(trace_record *rec)
+{
+	return (rec->size >> 4) == 0;
+}
+
+static inline unsigned long gap_cycles(trace_record *rec)
+{
+	return rec->pc | ((unsigned long)rec->operand << 16);
+}
+
+// Delta coded trace
+// 	The records come in chunks, each a keyframe followed by the coded
+// 	records.  A record is a tag byte and the fields its bits ask for.  A
+// 	field is only there when it can't be predicted from what happened the
+// 	last time the same PC ran.  The PC itself is predicted as the one that
+// 	followed the last PC then, or the next instruction if there wasn't
+// 	one.  The instruction length comes from the opcode, so it is never
+// 	stored.  Nothing is predicted across a keyframe, so decoding can start
+// 	at any of them, and the keyframes' cycle counts let a decoder skip to
+// 	a cycle.  The cycle counts include gaps, so they are run cycles.
+#define TRACE_KEYFRAME 65536		// records in a chunk
+
+#define TD_PC		0x01			// PC follows, low byte first
+#define TD_SR		0x02			// SR follows
+#define TD_OP		0x04			// opcode follows
+#define TD_OPERAND	0x08			// operand follows, low byte first
+#define TD_RESULT	0x10			// result follows
+#define TD_CYCLES	0x20			// cycles follow
+#define TD_GAP		0x40			// gap record, 4 bytes of cycles follow
+
+typedef struct trace_keyframe
+{
+	unsigned int length;					// bytes of coded records after it
+	unsigned int records;
+	unsigned long long first_record;	// records before the chunk
+	unsigned long long first_cycle;	// cycles before the chunk
+	unsigned long long cycles;			// cycles in the chunk
+} trace_keyframe;
+
+// Delta coder state, private to trace.c
+struct trace_coder;
+
+// Single producer, single consumer ring
+// 	The emulator adds records at head, the writer takes them from tail.
+// 	Each side only writes its own index, so no locks are needed.
+typedef struct trace_file
+{
+	FILE *file;
+	trace_record *buf;		// TRACE_RING records
+	int mode;					// TRACE_BLOCK or TRACE_DROP
+	struct trace_coder *coder;	// for TRACE_DELTA, NULL for TRACE_RAW
+
+	// Emulator's side
+	unsigned long head;		// next record to fill
+	unsigned long tail_seen;	// tail when last looked at
+	unsigned long long dropped;	// records dropped with TRACE_DROP
+	unsigned long long stalls;		// times it waited with TRACE_BLOCK
+	unsigned long long skipped;	// cycles left out since the last record
+
+	int error;					// 1 once a write has failed
+#ifdef TRACE_THREAD
+	// Each index on its own cache line
+	char pad1[64];
+	atomic_ulong published;	// head as the writer may see it
+	char pad2[64];
+	atomic_ulong tail;		// next record to write
+	char pad3[64];
+	atomic_int done;			// set once the last record is published
+	pthread_t writer;
+#endif
+} trace_file;
+
+int open_trace(char *filename, trace_file *t, int mode, int format);
+	// mode is TRACE_BLOCK or TRACE_DROP, format TRACE_RAW or TRACE_DELTA
+	// returns 0 on success
+	// 		-1 on file open error
+	// 		-2 if the buffer or writer can't be set up
+	// 		-3 on file write error
+int trace_full(trace_file *t);
+	// Called by trace_add when the ring looks full
+	// returns 0 once there is room
+	// 		-1 if the record is to be dropped
+int close_trace(trace_file *t);
+	// Writes out what's left and stops the writer
+	// returns 0 on success
+	// 		-3 on file write error
+
+// Put a record in the ring
+// returns 0 on success
+// 		-1 if it was dropped
+static inline int trace_put(trace_file *t, word pc, byte op, word operand,
+		byte result, byte sr, byte size)
+{
+	trace_record *rec;
+
+	if ((t->head - t->tail_seen == TRACE_RING) && (trace_full(t) != 0))
+	{
+		return -1;
+	}
+
+	rec = &t->buf[t->head & (TRACE_RING - 1)];
+	rec->pc = pc;
+	rec->operand = operand;
+	rec->op = op;
+	rec->result = result;
+	rec->sr = sr;
+	rec->size = size;
+	t->head++;
+
+#ifdef TRACE_THREAD
+	if ((t->head & (TRACE_BATCH - 1)) == 0)
+	{
+		atomic_store_explicit(&t->published, t->head, memory_order_release);
+	}
+#endif
+	return 0;
+}
+
+// Put a gap record for the cycles skipped so far, up to TRACE_GAP_MAX
+// returns 0 on success
+// 		-1 if it was dropped, the cycles are kept for the next one
+static inline int trace_put_gap(trace_file *t)
+{
+	unsigned long gap = (t->skipped > TRACE_GAP_MAX) ? TRACE_GAP_MAX :
+		(unsigned long)t->skipped;
+
+	if (trace_put(t, gap & 0xFFFF, 0, gap >> 16, 0, 0, 0) != 0)
+	{
+		return -1;
+	}
+	t->skipped -= gap;
+	return 0;
+}
+
+// Count the cycles of an instruction left out by a filter
+// 	A full gap is put out first.  If it's dropped the cycles still count,
+// 	the next gap records carry them.
+static inline void trace_skip(trace_file *t, int cycles)
+{
+	if (t->skipped > TRACE_GAP_MAX - cycles)
+	{
+		trace_put_gap(t);
+	}
+	t->skipped += cycles;
+}
+
+// Add a record
+// 	After a gap record if any instructions were left out before it.  One
+// 	dropped with its gap counts as left out, so the cycles stay right.
+static inline void trace_add(trace_file *t, word pc, byte op, word operand,
+		byte result, byte sr, int bytes, int cycles)
+{
+	while (t->skipped != 0)
+	{
+		if (trace_put_gap(t) != 0)
+		{
+			t->dropped++;
+			trace_skip(t, cycles);
+			return;
+		}
+	}
+	if (trace_put(t, pc, op, operand, result, sr,
+			(bytes << 4) | (cycles & 0x0F)) != 0)
+	{
+		trace_skip(t, cycles);
+	}
+}
+
+// Trace filter
+// 	Which instructions go in the code log or trace.  The PC and opcode
+// 	tests are a bit each, the cycle window a compare.  Cycles are counted
+// 	from the first instruction traced.
+#define OPS_BRANCH	0x01		// branches, jumps, calls and returns
+#define OPS_STACK	0x02		// pushes, pulls, calls, returns and S moves
+#define OPS_WRITE	0x04		// stores and read-modify-write to memory
+
+typedef struct trace_filter
+{
+	byte pc[MAX_MEM / 8];		// a bit for each address
+	byte op[256 / 8];				// a bit for each opcode
+	int pc_ranges;					// ranges added, 0 for every address
+	int op_groups;					// OPS_ bits added, 0 for every opcode
+	unsigned long long start;	// cycle window, start to before stop
+	unsigned long long stop;
+	unsigned long long cycle;	// cycles before this instruction
+} trace_filter;
+
+void init_filter(trace_filter *f);
+	// Everything passes until narrowed
+void filter_pc(trace_filter *f, word begin, word end);
+	// Instructions starting from begin to end (inclusive) pass, along with
+	// 	any other ranges added
+void filter_ops(trace_filter *f, int groups);
+	// Opcodes in the OPS_ groups pass, along with any added before
+int op_group(char *name);
+	// returns the OPS_ bit for "branch", "stack" or "write"
+	// 		0 for any other name
+void filter_cycles(trace_filter *f, unsigned long long start,
+		unsigned long long stop);
+	// Instructions starting in the window pass, stop 0 for no end
+
+// 1 if the instruction passes, counting its cycles either way
+static inline int filter_pass(trace_filter *f, word pc, byte op, int cycles)
+{
+	unsigned long long cycle = f->cycle;
+
+	f->cycle += cycles;
+	return ((f->pc[pc >> 3] >> (pc & 7)) & (f->op[op >> 3] >> (op & 7)) & 1) &&
+		(cycle >= f->start) && (cycle < f->stop);
+}
+
+// The code log line for a record
+void print_record(FILE *out, trace_record *rec, const char *mnemonic);
+
+// Decode a chunk of a delta coded trace
+int decode_chunk(byte *data, trace_keyframe *key, trace_record *recs);
+	// data is the key->length bytes after the keyframe, recs has room for
+	// 	key->records records
+	// returns 0 on success
+	// 		-2 if the chunk doesn't decode to key->records records
+
+#endif
@@ -0,0 +1,221 @@
+// tracedec.c
+//
+// 6502 emulator program
+// 	Trace decoder, turns a binary trace from em6502 -t into the code log
+//
+// Brian K. Niece
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "em6502.h"
+#include "cpu.h"
+#include "instructions.h"
+#include "membus.h"
+#include "trace.h"
+#include "version.h"
+
+// Mnemonic for each opcode, as the instruction handlers give it
+static const char *mnemonics[256];
+
+static void find_mnemonics()
+// Run each handler once on a scratch machine to get its mnemonic
+{
+	membus bus;
+	CPU cpu;
+
+	initialize_bus(&bus);
+	initialize_cpu(&cpu, &bus);
+
+	for (int op = 0; op < 256; op++)
+	{
+		cpu.PC = DEF_CODE_ADDR;
+		cpu.SP = 0xFF;
+		mnemonics[op] = execute_binary[op](&cpu).mnemonic;
+	}
+
+	free_bus(&bus);
+}
+
+static void print_from(FILE *out, trace_record *rec, unsigned long long *cycle,
+		unsigned long long start, unsigned long long *count)
+// Print a record if it starts at or after the start cycle
+// 	Gap records only move the cycle on
+{
+	if (trace_gap(rec))
+	{
+		*cycle += gap_cycles(rec);
+		return;
+	}
+	if (*cycle >= start)
+	{
+		print_record(out, rec, mnemonics[rec->op]);
+		(*count)++;
+	}
+	*cycle += rec->size & 0x0F;
+}
+
+static int decode_raw(FILE *file, FILE *out, unsigned long long start,
+		unsigned long long *count)
+// Fixed size records, read back a batch at a time
+{
+	trace_record *buf = malloc(TRACE_BATCH * sizeof(trace_record));
+	unsigned long long cycle = 0;
+	size_t n;
+
+	while ((n = fread(buf, sizeof(trace_record), TRACE_BATCH, file)) > 0)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			print_from(out, &buf[i], &cycle, start, count);
+		}
+	}
+	free(buf);
+
+	return 0;
+}
+
+static int decode_delta(FILE *file, FILE *out, unsigned long long start,
+		unsigned long long *count)
+// Delta coded chunks, skipping whole chunks that end before the start
+// returns 0 on success
+// 		-2 on a chunk that is cut short or doesn't decode
+{
+	trace_keyframe key;
+	trace_record *recs = malloc(TRACE_KEYFRAME * sizeof(trace_record));
+	byte *data = NULL;
+	unsigned long long cycle;
+	int r = 0;
+
+	while (fread(&key, sizeof(key), 1, file) == 1)
+	{
+		if (key.records > TRACE_KEYFRAME)
+		{
+			r = -2;
+			break;
+		}
+		if (key.first_cycle + key.cycles <= start)
+		{
+			fseek(file, key.length, SEEK_CUR);
+			continue;
+		}
+
+		data = realloc(data, key.length);
+		if ((fread(data, 1, key.length, file) != key.length) ||
+				(decode_chunk(data, &key, recs) != 0))
+		{
+			r = -2;
+			break;
+		}
+
+		cycle = key.first_cycle;
+		for (unsigned int i = 0; i < key.records; i++)
+		{
+			print_from(out, &recs[i], &cycle, start, count);
+		}
+	}
+	free(data);
+	free(recs);
+
+	return r;
+}
+
+int main(int argc, char *argv[])
+{
+	int c, opt_idx = 0;	// getopt variables
+	int r;
+	char *trace_name = "trace.bin";
+	char *out_name = NULL;
+	FILE *file, *out = stdout;
+	trace_header head;
+	unsigned long long start = 0;
+	unsigned long long count = 0;
+
+	opterr = 0;
+
+	struct option long_opts[] =
+	{
+		{"version", no_argument, 0, 'v'},
+		{"input-file", required_argument, 0, 'i'},
+		{"output-file", required_argument, 0, 'o'},
+		{"start-cycle", required_argument, 0, 's'},
+		{0, 0, 0, 0}
+	};
+
+	while ((c = getopt_long(argc, argv, "vi:o:s:", long_opts, &opt_idx)) != -1)
+		switch (c)
+		{
+			case 'v':
+				printf("em6502td (6502 trace decoder) %.1f\n", VERSION);
+				printf("Copyright (c) %d Brian K. Niece\n", COPYRIGHT);
+				printf("Built %s\n", __DATE__);
+				return 0;
+				break;
+			case 'i':
+				trace_name = optarg;
+				break;
+			case 'o':
+				out_name = optarg;
+				break;
+			case 's':
+				start = strtoull(optarg, NULL, 0);
+				break;
+		}
+
+	file = fopen(trace_name, "rb");
+	if (file == NULL)
+	{
+		printf("Error opening trace file: %s\n", trace_name);
+		return -1;
+	}
+	if ((fread(&head, sizeof(head), 1, file) != 1) ||
+			(memcmp(head.magic, TRACE_MAGIC, 4) != 0) ||
+			((head.version != TRACE_VERSION) &&
+			 (head.version != TRACE_DELTA_VERSION)) ||
+			(head.record_size != sizeof(trace_record)))
+	{
+		printf("Not a trace file from this build: %s\n", trace_name);
+		fclose(file);
+		return -1;
+	}
+
+	if (out_name != NULL)
+	{
+		out = fopen(out_name, "w");
+		if (out == NULL)
+		{
+			printf("Error opening output file: %s\n", out_name);
+			fclose(file);
+			return -1;
+		}
+	}
+
+	find_mnemonics();
+
+	if (head.version == TRACE_DELTA_VERSION)
+	{
+		r = decode_delta(file, out, start, &count);
+	}
+	else
+	{
+		r = decode_raw(file, out, start, &count);
+	}
+	fclose(file);
+
+	if (out != stdout)
+	{
+		fclose(out);
+		printf("Decoded %llu instructions from %s to %s\n", count, trace_name,
+			out_name);
+	}
+	if (r != 0)
+	{
+		printf("Trace file is damaged after %llu instructions: %s\n", count,
+			trace_name);
+		return -1;
+	}
+
+	return 0;
+}